@@ -0,0 +1,177 @@
+#pragma once
+
+#include "dijkstra_router.h"
+#include "graph.h"
+#include "router.h"
+
+#include <algorithm>
+#include <functional>
+#include <optional>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+/**
+ * Маршрутизатор, строящий маршрут двунаправленным поиском Дейкстры в момент запроса:
+ * прямой поиск идет от начальной вершины по исходящим ребрам, обратный - от конечной
+ * по входящим. Требует построенных у графа списков входящих ребер
+*/
+template <typename Weight>
+class BidirectionalDijkstraRouter {
+private:
+    using Graph = DirectedWeightedGraph<Weight>;
+
+public:
+    using RouteInfo = typename Router<Weight>::RouteInfo;
+    using SearchStats = typename DijkstraRouter<Weight>::SearchStats;
+
+    explicit BidirectionalDijkstraRouter(const Graph& graph);
+
+    std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to, SearchStats* stats = nullptr) const;
+
+private:
+    using QueueItem = std::pair<Weight, VertexId>;
+    using Queue = std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>>;
+
+    // Состояние одного направления поиска
+    struct SearchState {
+        Queue queue;
+        std::vector<std::optional<Weight>> weights;
+        std::vector<std::optional<EdgeId>> edges; // Ребро, по которому вершина достигнута
+        std::vector<bool> settled;
+    };
+
+    static constexpr Weight ZERO_WEIGHT{};
+    const Graph& graph_;
+
+    size_t SearchStep(SearchState& state, const SearchState& other_state, bool is_forward,
+        std::optional<Weight>& best_weight, VertexId& meeting_vertex) const;
+};
+
+template <typename Weight>
+BidirectionalDijkstraRouter<Weight>::BidirectionalDijkstraRouter(const Graph& graph)
+    : graph_(graph)
+{
+    if (!graph_.HasReverseIncidence()) {
+        throw std::invalid_argument("Graph should have reverse incidence lists");
+    }
+    for (const auto& edge : graph_.GetEdges()) {
+        if (edge.weight < ZERO_WEIGHT) {
+            throw std::domain_error("Edges' weights should be non-negative");
+        }
+    }
+}
+
+template <typename Weight>
+std::optional<typename BidirectionalDijkstraRouter<Weight>::RouteInfo>
+BidirectionalDijkstraRouter<Weight>::BuildRoute(VertexId from, VertexId to, SearchStats* stats) const {
+    const size_t vertex_count = graph_.GetVertexCount();
+    if (from >= vertex_count || to >= vertex_count) {
+        throw std::out_of_range("Vertex id is out of range");
+    }
+
+    // Состояние поиска хранится локально, поэтому метод можно вызывать конкурентно
+    SearchState forward{{}, std::vector<std::optional<Weight>>(vertex_count),
+        std::vector<std::optional<EdgeId>>(vertex_count), std::vector<bool>(vertex_count, false)};
+    SearchState backward{{}, std::vector<std::optional<Weight>>(vertex_count),
+        std::vector<std::optional<EdgeId>>(vertex_count), std::vector<bool>(vertex_count, false)};
+
+    forward.weights[from] = ZERO_WEIGHT;
+    forward.queue.push({ZERO_WEIGHT, from});
+    backward.weights[to] = ZERO_WEIGHT;
+    backward.queue.push({ZERO_WEIGHT, to});
+
+    std::optional<Weight> best_weight;
+    VertexId meeting_vertex = from;
+    if (from == to) {
+        best_weight = ZERO_WEIGHT;
+    }
+    size_t settled_count = 0;
+
+    // Любой путь короче найденного прошел бы через вершины, еще не извлеченные
+    // обоими поисками, и весил бы не меньше суммы весов в вершинах очередей
+    while (!forward.queue.empty() && !backward.queue.empty()) {
+        if (best_weight && !(forward.queue.top().first + backward.queue.top().first < *best_weight)) {
+            break;
+        }
+
+        if (forward.queue.top().first <= backward.queue.top().first) {
+            settled_count += SearchStep(forward, backward, true, best_weight, meeting_vertex);
+        }
+        else {
+            settled_count += SearchStep(backward, forward, false, best_weight, meeting_vertex);
+        }
+    }
+
+    if (stats != nullptr) {
+        stats->settled_vertices = settled_count;
+    }
+
+    if (!best_weight) {
+        return std::nullopt;
+    }
+
+    // Восстанавливаем маршрут: от начальной вершины до точки встречи и от неё до конечной
+    std::vector<EdgeId> edges;
+    for (std::optional<EdgeId> edge_id = forward.edges[meeting_vertex];
+         edge_id;
+         edge_id = forward.edges[graph_.GetEdge(*edge_id).from])
+    {
+        edges.push_back(*edge_id);
+    }
+    std::reverse(edges.begin(), edges.end());
+    for (std::optional<EdgeId> edge_id = backward.edges[meeting_vertex];
+         edge_id;
+         edge_id = backward.edges[graph_.GetEdge(*edge_id).to])
+    {
+        edges.push_back(*edge_id);
+    }
+
+    return RouteInfo{*best_weight, std::move(edges)};
+}
+
+/**
+ * Извлекает вершину из очереди одного направления и релаксирует её ребра.
+ * Для каждой вершины, достигнутой и встречным поиском, обновляет лучший найденный маршрут.
+ * Возвращает 1, если вершина извлечена впервые, иначе 0
+*/
+template <typename Weight>
+size_t BidirectionalDijkstraRouter<Weight>::SearchStep(SearchState& state, const SearchState& other_state,
+    bool is_forward, std::optional<Weight>& best_weight, VertexId& meeting_vertex) const {
+    const VertexId vertex = state.queue.top().second;
+    state.queue.pop();
+    if (state.settled[vertex]) {
+        return 0;
+    }
+    state.settled[vertex] = true;
+    const Weight weight = *state.weights[vertex];
+
+    const auto edges = is_forward ? graph_.GetIncidentEdges(vertex) : graph_.GetIncomingEdges(vertex);
+    for (const EdgeId edge_id : edges) {
+        const auto& edge = graph_.GetEdge(edge_id);
+        const VertexId next = is_forward ? edge.to : edge.from;
+        if (state.settled[next]) {
+            continue;
+        }
+
+        const Weight candidate_weight = weight + edge.weight;
+        auto& weight_next = state.weights[next];
+        if (!weight_next || candidate_weight < *weight_next) {
+            weight_next = candidate_weight;
+            state.edges[next] = edge_id;
+            state.queue.push({candidate_weight, next});
+
+            const auto& other_weight = other_state.weights[next];
+            if (other_weight && (!best_weight || candidate_weight + *other_weight < *best_weight)) {
+                best_weight = candidate_weight + *other_weight;
+                meeting_vertex = next;
+            }
+        }
+    }
+    return 1;
+}
+
+}  // namespace graph
@@ -0,0 +1,272 @@
+#pragma once
+
+#include "graph.h"
+#include "router.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <queue>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+/**
+ * Маршрутизатор по сжатой таблице маршрутов между всеми парами вершин. Для каждой пары
+ * хранится только последнее ребро кратчайшего пути - номером среди входящих ребер конечной
+ * вершины, в ячейке 1, 2 или 4 байт по наибольшему числу входящих ребер. Вершины
+ * с единственным входящим ребром столбца не имеют: последнее ребро пути до них известно заранее.
+ * Веса в таблице не хранятся и суммируются по ребрам при построении маршрута.
+ * Строки таблицы рассчитываются поиском Дейкстры от каждой вершины, полная таблица весов
+ * в памяти не создается. Требует построенных у графа списков входящих ребер
+*/
+template <typename Weight>
+class CompactRouter {
+private:
+    using Graph = DirectedWeightedGraph<Weight>;
+
+public:
+    using RouteInfo = typename Router<Weight>::RouteInfo;
+
+    /**
+     * Сжатая таблица маршрутов: vertex_count строк по числу вершин, в строке - ячейки
+     * cell_size байт по столбцам. Значение ячейки: 0 - маршрута нет, k + 1 - последнее ребро
+     * маршрута k-е среди входящих ребер вершины столбца. Байты ячейки - от младшего к старшему
+    */
+    struct CompactRoutesData {
+        size_t vertex_count = 0;
+        size_t cell_size = 0;
+        std::vector<uint8_t> cells;
+    };
+
+    explicit CompactRouter(const Graph& graph, size_t threads_count = 1);
+    CompactRouter(const Graph& graph, CompactRoutesData compact_routes_data);
+
+    std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const;
+    const CompactRoutesData& GetCompactRoutesData() const;
+
+private:
+    using QueueItem = std::pair<Weight, VertexId>;
+    using Queue = std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>>;
+
+    static constexpr Weight ZERO_WEIGHT{};
+    static constexpr uint32_t NO_COLUMN = std::numeric_limits<uint32_t>::max();
+    static constexpr uint32_t NO_ROUTE = 0;
+
+    const Graph& graph_;
+    std::vector<uint32_t> columns_; // Столбец вершины в таблице, NO_COLUMN - столбца нет
+    size_t column_count_ = 0;
+    CompactRoutesData compact_routes_data_;
+
+    size_t InitializeColumns();
+    void FillRows(VertexId first_row, size_t rows_step);
+    uint32_t GetCell(VertexId from, uint32_t column) const;
+    void SetCell(VertexId from, uint32_t column, uint32_t value);
+};
+
+template <typename Weight>
+CompactRouter<Weight>::CompactRouter(const Graph& graph, size_t threads_count)
+    : graph_(graph)
+{
+    if (!graph_.HasReverseIncidence()) {
+        throw std::invalid_argument("Graph should have reverse incidence lists");
+    }
+    const size_t max_incoming = InitializeColumns();
+    for (const auto& edge : graph_.GetEdges()) {
+        if (edge.weight < ZERO_WEIGHT) {
+            throw std::domain_error("Edges' weights should be non-negative");
+        }
+    }
+
+    // Ячейка вмещает номер любого входящего ребра, увеличенный на 1
+    const size_t vertex_count = graph_.GetVertexCount();
+    compact_routes_data_.vertex_count = vertex_count;
+    compact_routes_data_.cell_size = max_incoming < std::numeric_limits<uint8_t>::max() ? 1
+        : (max_incoming < std::numeric_limits<uint16_t>::max() ? 2 : 4);
+    compact_routes_data_.cells.assign(vertex_count * column_count_ * compact_routes_data_.cell_size, 0);
+
+    // Строки независимы и распределяются между потоками по номеру строки
+    threads_count = std::max<size_t>(1, std::min(threads_count, vertex_count));
+    std::vector<std::thread> threads;
+    threads.reserve(threads_count - 1);
+    for (size_t thread_index = 1; thread_index < threads_count; ++thread_index) {
+        threads.emplace_back([this, thread_index, threads_count] { FillRows(thread_index, threads_count); });
+    }
+    FillRows(0, threads_count);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+template <typename Weight>
+CompactRouter<Weight>::CompactRouter(const Graph& graph, CompactRoutesData compact_routes_data)
+    : graph_(graph)
+    , compact_routes_data_(std::move(compact_routes_data))
+{
+    if (!graph_.HasReverseIncidence()) {
+        throw std::invalid_argument("Graph should have reverse incidence lists");
+    }
+    const size_t max_incoming = InitializeColumns();
+    const size_t cell_size = compact_routes_data_.cell_size;
+    if (compact_routes_data_.vertex_count != graph_.GetVertexCount()
+        || (cell_size != 1 && cell_size != 2 && cell_size != 4)
+        || (cell_size < 4 && max_incoming >= (size_t{1} << (8 * cell_size)) - 1)
+        || compact_routes_data_.cells.size() != graph_.GetVertexCount() * column_count_ * cell_size) {
+        throw std::invalid_argument("Compact routes data doesn't match the graph");
+    }
+}
+
+/**
+ * Строит маршрут от конечной вершины к начальной по последним ребрам маршрутов из from
+ * и суммирует веса ребер в порядке пути
+*/
+template <typename Weight>
+std::optional<typename CompactRouter<Weight>::RouteInfo> CompactRouter<Weight>::BuildRoute(
+    VertexId from, VertexId to) const {
+    const size_t vertex_count = compact_routes_data_.vertex_count;
+    if (from >= vertex_count || to >= vertex_count) {
+        throw std::out_of_range("Vertex id is out of range");
+    }
+
+    std::vector<EdgeId> edges;
+    for (VertexId vertex = to; vertex != from; vertex = graph_.GetEdge(edges.back()).from) {
+        const auto incoming = graph_.GetIncomingEdges(vertex);
+        // Кратчайший путь не длиннее vertex_count - 1 ребер: более длинная цепочка единственных
+        // входящих ребер - цикл, не проходящий через from
+        if (incoming.begin() == incoming.end() || edges.size() >= vertex_count) {
+            return std::nullopt;
+        }
+        if (columns_[vertex] == NO_COLUMN) {
+            edges.push_back(*incoming.begin());
+            continue;
+        }
+        const uint32_t cell = GetCell(from, columns_[vertex]);
+        if (cell == NO_ROUTE) {
+            return std::nullopt;
+        }
+        edges.push_back(*std::next(incoming.begin(), cell - 1));
+    }
+    std::reverse(edges.begin(), edges.end());
+
+    Weight weight = ZERO_WEIGHT;
+    for (const EdgeId edge_id : edges) {
+        weight += graph_.GetEdge(edge_id).weight;
+    }
+    return RouteInfo{weight, std::move(edges)};
+}
+
+template <typename Weight>
+const typename CompactRouter<Weight>::CompactRoutesData& CompactRouter<Weight>::GetCompactRoutesData() const {
+    return compact_routes_data_;
+}
+
+/**
+ * Задает столбцы таблицы вершинам, в которые входит больше одного ребра.
+ * Возвращает наибольшее число входящих ребер вершины
+*/
+template <typename Weight>
+size_t CompactRouter<Weight>::InitializeColumns() {
+    const size_t vertex_count = graph_.GetVertexCount();
+    columns_.assign(vertex_count, NO_COLUMN);
+    column_count_ = 0;
+    size_t max_incoming = 0;
+    for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+        const auto incoming = graph_.GetIncomingEdges(vertex);
+        const size_t incoming_count = static_cast<size_t>(std::distance(incoming.begin(), incoming.end()));
+        max_incoming = std::max(max_incoming, incoming_count);
+        if (incoming_count > 1) {
+            if (column_count_ >= NO_COLUMN) {
+                throw std::length_error("Too many vertices for the compact routes table");
+            }
+            columns_[vertex] = static_cast<uint32_t>(column_count_++);
+        }
+    }
+    if (max_incoming >= std::numeric_limits<uint32_t>::max()) {
+        throw std::length_error("Too many incoming edges for the compact routes table");
+    }
+    return max_incoming;
+}
+
+/**
+ * Заполняет строки first_row, first_row + rows_step, ... поиском Дейкстры от вершины строки.
+ * Последнее ребро пути до вершины - ребро, последним улучшившее её вес
+*/
+template <typename Weight>
+void CompactRouter<Weight>::FillRows(VertexId first_row, size_t rows_step) {
+    const size_t vertex_count = graph_.GetVertexCount();
+    std::vector<Weight> weights(vertex_count);
+    std::vector<bool> settled(vertex_count);
+    std::vector<uint32_t> prev_edges(vertex_count); // Номер последнего ребра среди входящих + 1
+
+    // Номер каждого ребра среди входящих ребер его конечной вершины
+    std::vector<uint32_t> incoming_positions(graph_.GetEdgeCount());
+    for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+        uint32_t position = 0;
+        for (const EdgeId edge_id : graph_.GetIncomingEdges(vertex)) {
+            incoming_positions[edge_id] = position++;
+        }
+    }
+
+    for (VertexId from = first_row; from < vertex_count; from += rows_step) {
+        std::fill(weights.begin(), weights.end(), ZERO_WEIGHT);
+        std::fill(settled.begin(), settled.end(), false);
+        std::fill(prev_edges.begin(), prev_edges.end(), NO_ROUTE);
+
+        Queue queue;
+        queue.push({ZERO_WEIGHT, from});
+        while (!queue.empty()) {
+            const VertexId vertex = queue.top().second;
+            queue.pop();
+            if (settled[vertex]) {
+                continue;
+            }
+            settled[vertex] = true;
+
+            for (const EdgeId edge_id : graph_.GetIncidentEdges(vertex)) {
+                const auto& edge = graph_.GetEdge(edge_id);
+                const Weight candidate_weight = weights[vertex] + edge.weight;
+                if (edge.to == from || settled[edge.to]
+                    || (prev_edges[edge.to] != NO_ROUTE && !(candidate_weight < weights[edge.to]))) {
+                    continue;
+                }
+                weights[edge.to] = candidate_weight;
+                prev_edges[edge.to] = incoming_positions[edge_id] + 1;
+                queue.push({candidate_weight, edge.to});
+            }
+        }
+
+        for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+            if (columns_[vertex] != NO_COLUMN && prev_edges[vertex] != NO_ROUTE) {
+                SetCell(from, columns_[vertex], prev_edges[vertex]);
+            }
+        }
+    }
+}
+
+template <typename Weight>
+uint32_t CompactRouter<Weight>::GetCell(VertexId from, uint32_t column) const {
+    const size_t cell_size = compact_routes_data_.cell_size;
+    const uint8_t* cell = compact_routes_data_.cells.data() + (from * column_count_ + column) * cell_size;
+    uint32_t value = 0;
+    for (size_t byte = cell_size; byte > 0; --byte) {
+        value = (value << 8) | cell[byte - 1];
+    }
+    return value;
+}
+
+template <typename Weight>
+void CompactRouter<Weight>::SetCell(VertexId from, uint32_t column, uint32_t value) {
+    const size_t cell_size = compact_routes_data_.cell_size;
+    uint8_t* cell = compact_routes_data_.cells.data() + (from * column_count_ + column) * cell_size;
+    for (size_t byte = 0; byte < cell_size; ++byte) {
+        cell[byte] = static_cast<uint8_t>(value >> (8 * byte));
+    }
+}
+
+}  // namespace graph
@@ -0,0 +1,197 @@
+#pragma once
+
+#include "graph.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+/**
+ * Индекс связности орграфа, позволяющий за O(1) отбросить пары вершин, между которыми
+ * нет пути. Хранит для каждой вершины номер компоненты слабой связности и номер компоненты
+ * сильной связности. Компоненты сильной связности нумеруются алгоритмом Тарьяна
+ * в обратном топологическом порядке: если из компоненты a достижима компонента b, то b <= a
+*/
+class ConnectivityIndex {
+public:
+    /**
+     * Номера компонент вершин, достаточные для создания индекса без повторного расчета
+    */
+    struct ComponentsData {
+        std::vector<uint32_t> weak_components;
+        std::vector<uint32_t> strong_components;
+    };
+
+    template <typename Weight>
+    explicit ConnectivityIndex(const DirectedWeightedGraph<Weight>& graph);
+    ConnectivityIndex(size_t vertex_count, ComponentsData components_data);
+
+    bool MayReach(VertexId from, VertexId to) const;
+    const ComponentsData& GetComponentsData() const;
+
+private:
+    static constexpr uint32_t NO_INDEX = std::numeric_limits<uint32_t>::max();
+
+    ComponentsData components_data_;
+
+    template <typename Weight>
+    void ComputeWeakComponents(const DirectedWeightedGraph<Weight>& graph);
+    template <typename Weight>
+    void ComputeStrongComponents(const DirectedWeightedGraph<Weight>& graph);
+};
+
+template <typename Weight>
+ConnectivityIndex::ConnectivityIndex(const DirectedWeightedGraph<Weight>& graph) {
+    if (graph.GetVertexCount() >= NO_INDEX) {
+        throw std::length_error("Too many vertices for the connectivity index");
+    }
+    ComputeWeakComponents(graph);
+    ComputeStrongComponents(graph);
+}
+
+inline ConnectivityIndex::ConnectivityIndex(size_t vertex_count, ComponentsData components_data)
+    : components_data_(std::move(components_data))
+{
+    if (components_data_.weak_components.size() != vertex_count
+        || components_data_.strong_components.size() != vertex_count) {
+        throw std::invalid_argument("Components count doesn't match the graph");
+    }
+}
+
+/**
+ * Возвращает false, если пути из from в to точно нет: вершины в разных компонентах
+ * слабой связности, либо компонента сильной связности to не может быть достижима из
+ * компоненты from. true не гарантирует существования пути
+*/
+inline bool ConnectivityIndex::MayReach(VertexId from, VertexId to) const {
+    const auto& weak = components_data_.weak_components;
+    const auto& strong = components_data_.strong_components;
+    if (from >= weak.size() || to >= weak.size()) {
+        throw std::out_of_range("Vertex id is out of range");
+    }
+    return weak[from] == weak[to] && strong[to] <= strong[from];
+}
+
+inline const ConnectivityIndex::ComponentsData& ConnectivityIndex::GetComponentsData() const {
+    return components_data_;
+}
+
+/**
+ * Находит компоненты слабой связности системой непересекающихся множеств по ребрам графа,
+ * компоненты нумеруются по возрастанию их наименьшей вершины
+*/
+template <typename Weight>
+void ConnectivityIndex::ComputeWeakComponents(const DirectedWeightedGraph<Weight>& graph) {
+    const size_t vertex_count = graph.GetVertexCount();
+    std::vector<VertexId> parents(vertex_count);
+    std::iota(parents.begin(), parents.end(), VertexId{0});
+
+    const auto find_root = [&parents](VertexId vertex) {
+        while (parents[vertex] != vertex) {
+            parents[vertex] = parents[parents[vertex]];
+            vertex = parents[vertex];
+        }
+        return vertex;
+    };
+
+    for (const auto& edge : graph.GetEdges()) {
+        const VertexId from_root = find_root(edge.from);
+        const VertexId to_root = find_root(edge.to);
+        if (from_root != to_root) {
+            parents[std::max(from_root, to_root)] = std::min(from_root, to_root);
+        }
+    }
+
+    auto& weak = components_data_.weak_components;
+    weak.assign(vertex_count, NO_INDEX);
+    uint32_t component_count = 0;
+    for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+        const VertexId root = find_root(vertex);
+        if (weak[root] == NO_INDEX) {
+            weak[root] = component_count++;
+        }
+        weak[vertex] = weak[root];
+    }
+}
+
+/**
+ * Находит компоненты сильной связности алгоритмом Тарьяна. Обход в глубину ведется
+ * явным стеком, поэтому глубина графа не ограничена размером стека вызовов
+*/
+template <typename Weight>
+void ConnectivityIndex::ComputeStrongComponents(const DirectedWeightedGraph<Weight>& graph) {
+    const size_t vertex_count = graph.GetVertexCount();
+    using EdgeIterator = decltype(graph.GetIncidentEdges(0).begin());
+
+    // Кадр обхода: вершина и следующее непросмотренное ребро
+    struct Frame {
+        VertexId vertex;
+        EdgeIterator next_edge;
+        EdgeIterator end;
+    };
+
+    std::vector<uint32_t> order(vertex_count, NO_INDEX); // Порядок входа в вершину
+    std::vector<uint32_t> low(vertex_count, 0);
+    std::vector<bool> on_stack(vertex_count, false);
+    std::vector<VertexId> stack;
+    std::vector<Frame> frames;
+
+    auto& strong = components_data_.strong_components;
+    strong.assign(vertex_count, NO_INDEX);
+    uint32_t next_order = 0;
+    uint32_t component_count = 0;
+
+    const auto enter = [&](VertexId vertex) {
+        order[vertex] = low[vertex] = next_order++;
+        stack.push_back(vertex);
+        on_stack[vertex] = true;
+        const auto edges = graph.GetIncidentEdges(vertex);
+        frames.push_back({vertex, edges.begin(), edges.end()});
+    };
+
+    for (VertexId root = 0; root < vertex_count; ++root) {
+        if (order[root] != NO_INDEX) {
+            continue;
+        }
+        enter(root);
+
+        while (!frames.empty()) {
+            Frame& frame = frames.back();
+            if (frame.next_edge != frame.end) {
+                const VertexId next = graph.GetEdge(*frame.next_edge++).to;
+                if (order[next] == NO_INDEX) {
+                    enter(next);
+                }
+                else if (on_stack[next]) {
+                    low[frame.vertex] = std::min(low[frame.vertex], order[next]);
+                }
+                continue;
+            }
+
+            // Все ребра вершины просмотрены: если она корень компоненты - снимаем компоненту со стека
+            const VertexId vertex = frame.vertex;
+            frames.pop_back();
+            if (!frames.empty()) {
+                low[frames.back().vertex] = std::min(low[frames.back().vertex], low[vertex]);
+            }
+            if (low[vertex] == order[vertex]) {
+                VertexId member;
+                do {
+                    member = stack.back();
+                    stack.pop_back();
+                    on_stack[member] = false;
+                    strong[member] = component_count;
+                } while (member != vertex);
+                ++component_count;
+            }
+        }
+    }
+}
+
+}  // namespace graph
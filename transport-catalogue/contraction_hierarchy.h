@@ -0,0 +1,544 @@
+#pragma once
+
+#include "graph.h"
+#include "router.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+/**
+ * Маршрутизатор на основе иерархии сжатий (Contraction Hierarchies).
+ * При создании вершины графа по очереди "сжимаются": кратчайшие пути через сжимаемую
+ * вершину заменяются ребрами-сокращениями. Запрос - двунаправленный поиск Дейкстры
+ * только в сторону вершин большего ранга, сокращения найденного пути
+ * раскрываются в исходные ребра графа
+*/
+template <typename Weight>
+class ContractionHierarchyRouter {
+private:
+    using Graph = DirectedWeightedGraph<Weight>;
+
+public:
+    using RouteInfo = typename Router<Weight>::RouteInfo;
+
+    /**
+     * Ребро-сокращение, заменяющее путь из ребер иерархии first_edge и second_edge.
+     * Id ребер иерархии меньше числа ребер графа - исходные ребра, далее - сокращения по порядку
+    */
+    struct Shortcut {
+        VertexId from;
+        VertexId to;
+        Weight weight;
+        EdgeId first_edge;
+        EdgeId second_edge;
+    };
+    /**
+     * Данные иерархии, достаточные для создания маршрутизатора без повторного сжатия
+    */
+    struct ContractionData {
+        std::vector<size_t> ranks; // Порядковый номер сжатия каждой вершины
+        std::vector<Shortcut> shortcuts;
+    };
+
+    explicit ContractionHierarchyRouter(const Graph& graph);
+    ContractionHierarchyRouter(const Graph& graph, ContractionData contraction_data);
+
+    std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const;
+    const ContractionData& GetContractionData() const;
+
+private:
+    // Ребро иерархии в списке смежности вершины: соседняя вершина, вес и id ребра иерархии
+    struct Arc {
+        VertexId vertex;
+        Weight weight;
+        EdgeId edge_id;
+    };
+    // Изменяемый граф еще не сжатых вершин и состояние поиска путей-свидетелей
+    struct ContractionState {
+        std::vector<std::vector<Arc>> out_arcs;
+        std::vector<std::vector<Arc>> in_arcs;
+        std::vector<size_t> contracted_neighbours;
+        std::vector<std::optional<Weight>> witness_weights;
+        std::vector<VertexId> witness_touched;
+    };
+
+    using QueueItem = std::pair<Weight, VertexId>;
+    using Queue = std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>>;
+
+    static constexpr Weight ZERO_WEIGHT{};
+    // Число вершин, после просмотра которых поиск пути-свидетеля прекращается
+    static constexpr size_t WITNESS_SETTLED_LIMIT = 256;
+
+    const Graph& graph_;
+    ContractionData contraction_data_;
+
+    // Ребра иерархии в сжатом представлении: ребра вершины v - arcs[offsets[v], offsets[v + 1])
+    struct ArcsList {
+        std::vector<size_t> offsets;
+        std::vector<Arc> arcs;
+    };
+    // Состояние одного направления двунаправленного поиска
+    struct SearchState {
+        Queue queue;
+        std::vector<std::optional<Weight>> weights;
+        std::vector<std::optional<EdgeId>> prev_edges;
+    };
+
+    ArcsList upward_; // Ребра к вершинам большего ранга
+    ArcsList downward_; // Ребра от вершин большего ранга, хранятся у конечной вершины
+
+    void Contract();
+    std::vector<Shortcut> FindShortcuts(ContractionState& state, VertexId vertex) const;
+    void FindWitnesses(ContractionState& state, VertexId from, VertexId ignored, Weight max_weight) const;
+    static bool AddArc(ContractionState& state, VertexId from, VertexId to, Weight weight, EdgeId edge_id);
+
+    void BuildSearchGraphs();
+    static void SearchStep(SearchState& state, const SearchState& other_state, const ArcsList& search_arcs,
+        const ArcsList& stall_arcs, std::optional<Weight>& best_weight, VertexId& meeting_vertex);
+
+    VertexId GetEdgeFrom(EdgeId edge_id) const;
+    VertexId GetEdgeTo(EdgeId edge_id) const;
+    void UnpackEdge(EdgeId edge_id, std::vector<EdgeId>& edges) const;
+};
+
+template <typename Weight>
+ContractionHierarchyRouter<Weight>::ContractionHierarchyRouter(const Graph& graph)
+    : graph_(graph)
+{
+    for (const auto& edge : graph_.GetEdges()) {
+        if (edge.weight < ZERO_WEIGHT) {
+            throw std::domain_error("Edges' weights should be non-negative");
+        }
+    }
+    Contract();
+    BuildSearchGraphs();
+}
+
+template <typename Weight>
+ContractionHierarchyRouter<Weight>::ContractionHierarchyRouter(const Graph& graph,
+    ContractionData contraction_data)
+    : graph_(graph)
+    , contraction_data_(std::move(contraction_data))
+{
+    const size_t vertex_count = graph_.GetVertexCount();
+    if (contraction_data_.ranks.size() != vertex_count) {
+        throw std::invalid_argument("Ranks count doesn't match the graph");
+    }
+    // Сокращение может ссылаться только на исходные ребра и ранее созданные сокращения
+    EdgeId next_edge_id = graph_.GetEdgeCount();
+    for (const auto& shortcut : contraction_data_.shortcuts) {
+        if (shortcut.from >= vertex_count || shortcut.to >= vertex_count
+            || shortcut.first_edge >= next_edge_id || shortcut.second_edge >= next_edge_id) {
+            throw std::invalid_argument("Shortcut doesn't match the graph");
+        }
+        ++next_edge_id;
+    }
+    BuildSearchGraphs();
+}
+
+template <typename Weight>
+const typename ContractionHierarchyRouter<Weight>::ContractionData&
+ContractionHierarchyRouter<Weight>::GetContractionData() const {
+    return contraction_data_;
+}
+
+/**
+ * Сжимает вершины в порядке приоритета "разность ребер": число добавляемых сокращений
+ * минус число удаляемых ребер плюс число уже сжатых соседей. Приоритеты обновляются лениво -
+ * перед сжатием вершины её приоритет пересчитывается и сравнивается с лучшим в очереди
+*/
+template <typename Weight>
+void ContractionHierarchyRouter<Weight>::Contract() {
+    const size_t vertex_count = graph_.GetVertexCount();
+
+    ContractionState state{
+        std::vector<std::vector<Arc>>(vertex_count),
+        std::vector<std::vector<Arc>>(vertex_count),
+        std::vector<size_t>(vertex_count, 0),
+        std::vector<std::optional<Weight>>(vertex_count),
+        {}
+    };
+    for (EdgeId edge_id = 0; edge_id < graph_.GetEdgeCount(); ++edge_id) {
+        const auto& edge = graph_.GetEdge(edge_id);
+        if (edge.from != edge.to) {
+            AddArc(state, edge.from, edge.to, edge.weight, edge_id);
+        }
+    }
+
+    const auto get_priority = [&state](VertexId vertex, size_t shortcuts_count) {
+        return static_cast<int64_t>(shortcuts_count)
+            - static_cast<int64_t>(state.in_arcs[vertex].size() + state.out_arcs[vertex].size())
+            + static_cast<int64_t>(state.contracted_neighbours[vertex]);
+    };
+
+    using PriorityItem = std::pair<int64_t, VertexId>;
+    std::priority_queue<PriorityItem, std::vector<PriorityItem>, std::greater<PriorityItem>> queue;
+    for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+        queue.push({get_priority(vertex, FindShortcuts(state, vertex).size()), vertex});
+    }
+
+    std::vector<bool> is_contracted(vertex_count, false);
+    contraction_data_.ranks.assign(vertex_count, 0);
+    contraction_data_.shortcuts.clear();
+    size_t rank = 0;
+
+    while (!queue.empty()) {
+        const VertexId vertex = queue.top().second;
+        queue.pop();
+        if (is_contracted[vertex]) {
+            continue;
+        }
+
+        std::vector<Shortcut> shortcuts = FindShortcuts(state, vertex);
+        const int64_t priority = get_priority(vertex, shortcuts.size());
+        if (!queue.empty() && priority > queue.top().first) {
+            queue.push({priority, vertex});
+            continue;
+        }
+
+        for (const auto& shortcut : shortcuts) {
+            const EdgeId edge_id = graph_.GetEdgeCount() + contraction_data_.shortcuts.size();
+            if (AddArc(state, shortcut.from, shortcut.to, shortcut.weight, edge_id)) {
+                contraction_data_.shortcuts.push_back(shortcut);
+            }
+        }
+
+        // Удаляем вершину из графа несжатых вершин
+        for (const Arc& arc : state.in_arcs[vertex]) {
+            auto& neighbour_arcs = state.out_arcs[arc.vertex];
+            neighbour_arcs.erase(std::remove_if(neighbour_arcs.begin(), neighbour_arcs.end(),
+                [vertex](const Arc& other) { return other.vertex == vertex; }), neighbour_arcs.end());
+            ++state.contracted_neighbours[arc.vertex];
+        }
+        for (const Arc& arc : state.out_arcs[vertex]) {
+            auto& neighbour_arcs = state.in_arcs[arc.vertex];
+            neighbour_arcs.erase(std::remove_if(neighbour_arcs.begin(), neighbour_arcs.end(),
+                [vertex](const Arc& other) { return other.vertex == vertex; }), neighbour_arcs.end());
+            ++state.contracted_neighbours[arc.vertex];
+        }
+        state.in_arcs[vertex].clear();
+        state.in_arcs[vertex].shrink_to_fit();
+        state.out_arcs[vertex].clear();
+        state.out_arcs[vertex].shrink_to_fit();
+
+        is_contracted[vertex] = true;
+        contraction_data_.ranks[vertex] = rank++;
+    }
+}
+
+/**
+ * Возвращает сокращения, необходимые для сжатия вершины vertex: путь from -> vertex -> to
+ * заменяется сокращением, если не найден путь-свидетель в обход vertex не длиннее него
+*/
+template <typename Weight>
+std::vector<typename ContractionHierarchyRouter<Weight>::Shortcut>
+ContractionHierarchyRouter<Weight>::FindShortcuts(ContractionState& state, VertexId vertex) const {
+    std::vector<Shortcut> shortcuts;
+    const auto& out_arcs = state.out_arcs[vertex];
+    if (out_arcs.empty()) {
+        return shortcuts;
+    }
+
+    Weight max_out_weight = ZERO_WEIGHT;
+    for (const Arc& out_arc : out_arcs) {
+        max_out_weight = std::max(max_out_weight, out_arc.weight);
+    }
+
+    for (const Arc& in_arc : state.in_arcs[vertex]) {
+        FindWitnesses(state, in_arc.vertex, vertex, in_arc.weight + max_out_weight);
+
+        for (const Arc& out_arc : out_arcs) {
+            if (out_arc.vertex == in_arc.vertex) {
+                continue;
+            }
+            const Weight weight = in_arc.weight + out_arc.weight;
+            const auto& witness_weight = state.witness_weights[out_arc.vertex];
+            if (witness_weight && !(weight < *witness_weight)) {
+                continue;
+            }
+            shortcuts.push_back({in_arc.vertex, out_arc.vertex, weight, in_arc.edge_id, out_arc.edge_id});
+        }
+
+        for (const VertexId touched : state.witness_touched) {
+            state.witness_weights[touched].reset();
+        }
+        state.witness_touched.clear();
+    }
+
+    return shortcuts;
+}
+
+/**
+ * Ограниченный поиск Дейкстры из from в обход вершины ignored. Веса найденных путей
+ * остаются в state.witness_weights, изменённые вершины - в state.witness_touched
+*/
+template <typename Weight>
+void ContractionHierarchyRouter<Weight>::FindWitnesses(ContractionState& state, VertexId from,
+    VertexId ignored, Weight max_weight) const {
+    Queue queue;
+    state.witness_weights[from] = ZERO_WEIGHT;
+    state.witness_touched.push_back(from);
+    queue.push({ZERO_WEIGHT, from});
+
+    size_t settled_count = 0;
+    while (!queue.empty() && settled_count < WITNESS_SETTLED_LIMIT) {
+        const auto [weight, vertex] = queue.top();
+        queue.pop();
+        if (*state.witness_weights[vertex] < weight) {
+            continue;
+        }
+        if (max_weight < weight) {
+            break;
+        }
+        ++settled_count;
+
+        for (const Arc& arc : state.out_arcs[vertex]) {
+            if (arc.vertex == ignored) {
+                continue;
+            }
+            const Weight candidate_weight = weight + arc.weight;
+            auto& weight_to = state.witness_weights[arc.vertex];
+            if (!weight_to) {
+                state.witness_touched.push_back(arc.vertex);
+            }
+            if (!weight_to || candidate_weight < *weight_to) {
+                weight_to = candidate_weight;
+                queue.push({candidate_weight, arc.vertex});
+            }
+        }
+    }
+}
+
+/**
+ * Добавляет ребро from -> to в граф несжатых вершин, либо уменьшает вес уже существующего.
+ * Возвращает false, если существующее ребро не длиннее добавляемого
+*/
+template <typename Weight>
+bool ContractionHierarchyRouter<Weight>::AddArc(ContractionState& state, VertexId from, VertexId to,
+    Weight weight, EdgeId edge_id) {
+    auto& out_arcs = state.out_arcs[from];
+    const auto it = std::find_if(out_arcs.begin(), out_arcs.end(),
+        [to](const Arc& arc) { return arc.vertex == to; });
+
+    if (it == out_arcs.end()) {
+        out_arcs.push_back({to, weight, edge_id});
+        state.in_arcs[to].push_back({from, weight, edge_id});
+        return true;
+    }
+    if (!(weight < it->weight)) {
+        return false;
+    }
+
+    *it = {to, weight, edge_id};
+    for (Arc& arc : state.in_arcs[to]) {
+        if (arc.vertex == from) {
+            arc = {from, weight, edge_id};
+            break;
+        }
+    }
+    return true;
+}
+
+/**
+ * Раскладывает исходные ребра и сокращения по спискам поиска вверх и вниз по иерархии
+*/
+template <typename Weight>
+void ContractionHierarchyRouter<Weight>::BuildSearchGraphs() {
+    const size_t vertex_count = graph_.GetVertexCount();
+    const size_t edge_count = graph_.GetEdgeCount() + contraction_data_.shortcuts.size();
+    const auto& ranks = contraction_data_.ranks;
+
+    const auto get_weight = [this](EdgeId edge_id) {
+        return edge_id < graph_.GetEdgeCount()
+            ? graph_.GetEdge(edge_id).weight
+            : contraction_data_.shortcuts[edge_id - graph_.GetEdgeCount()].weight;
+    };
+
+    upward_.offsets.assign(vertex_count + 1, 0);
+    downward_.offsets.assign(vertex_count + 1, 0);
+    for (EdgeId edge_id = 0; edge_id < edge_count; ++edge_id) {
+        const VertexId from = GetEdgeFrom(edge_id);
+        const VertexId to = GetEdgeTo(edge_id);
+        if (ranks[from] < ranks[to]) {
+            ++upward_.offsets[from + 1];
+        }
+        else if (ranks[to] < ranks[from]) {
+            ++downward_.offsets[to + 1];
+        }
+    }
+    for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+        upward_.offsets[vertex + 1] += upward_.offsets[vertex];
+        downward_.offsets[vertex + 1] += downward_.offsets[vertex];
+    }
+
+    upward_.arcs.resize(upward_.offsets.back());
+    downward_.arcs.resize(downward_.offsets.back());
+    std::vector<size_t> upward_positions(upward_.offsets.begin(), upward_.offsets.end() - 1);
+    std::vector<size_t> downward_positions(downward_.offsets.begin(), downward_.offsets.end() - 1);
+    for (EdgeId edge_id = 0; edge_id < edge_count; ++edge_id) {
+        const VertexId from = GetEdgeFrom(edge_id);
+        const VertexId to = GetEdgeTo(edge_id);
+        if (ranks[from] < ranks[to]) {
+            upward_.arcs[upward_positions[from]++] = {to, get_weight(edge_id), edge_id};
+        }
+        else if (ranks[to] < ranks[from]) {
+            downward_.arcs[downward_positions[to]++] = {from, get_weight(edge_id), edge_id};
+        }
+    }
+}
+
+template <typename Weight>
+std::optional<typename ContractionHierarchyRouter<Weight>::RouteInfo>
+ContractionHierarchyRouter<Weight>::BuildRoute(VertexId from, VertexId to) const {
+    const size_t vertex_count = graph_.GetVertexCount();
+    if (from >= vertex_count || to >= vertex_count) {
+        throw std::out_of_range("Vertex id is out of range");
+    }
+
+    // Состояние поиска хранится локально, поэтому метод можно вызывать конкурентно
+    SearchState forward{{}, std::vector<std::optional<Weight>>(vertex_count),
+        std::vector<std::optional<EdgeId>>(vertex_count)};
+    SearchState backward{{}, std::vector<std::optional<Weight>>(vertex_count),
+        std::vector<std::optional<EdgeId>>(vertex_count)};
+
+    forward.weights[from] = ZERO_WEIGHT;
+    forward.queue.push({ZERO_WEIGHT, from});
+    backward.weights[to] = ZERO_WEIGHT;
+    backward.queue.push({ZERO_WEIGHT, to});
+
+    std::optional<Weight> best_weight;
+    VertexId meeting_vertex = from;
+
+    // Каждый шаг продолжает направление с меньшим весом в вершине очереди. Поиск закончен,
+    // когда ни одно направление не может улучшить найденный вес
+    while (!forward.queue.empty() || !backward.queue.empty()) {
+        const bool is_forward = backward.queue.empty()
+            || (!forward.queue.empty() && forward.queue.top().first <= backward.queue.top().first);
+        const Queue& queue = is_forward ? forward.queue : backward.queue;
+        if (best_weight && !(queue.top().first < *best_weight)) {
+            break;
+        }
+
+        if (is_forward) {
+            SearchStep(forward, backward, upward_, downward_, best_weight, meeting_vertex);
+        }
+        else {
+            SearchStep(backward, forward, downward_, upward_, best_weight, meeting_vertex);
+        }
+    }
+
+    if (!best_weight) {
+        return std::nullopt;
+    }
+
+    // Восстанавливаем ребра иерархии от from до точки встречи и от неё до to
+    std::vector<EdgeId> hierarchy_edges;
+    for (std::optional<EdgeId> edge_id = forward.prev_edges[meeting_vertex];
+         edge_id;
+         edge_id = forward.prev_edges[GetEdgeFrom(*edge_id)])
+    {
+        hierarchy_edges.push_back(*edge_id);
+    }
+    std::reverse(hierarchy_edges.begin(), hierarchy_edges.end());
+    for (std::optional<EdgeId> edge_id = backward.prev_edges[meeting_vertex];
+         edge_id;
+         edge_id = backward.prev_edges[GetEdgeTo(*edge_id)])
+    {
+        hierarchy_edges.push_back(*edge_id);
+    }
+
+    std::vector<EdgeId> edges;
+    for (const EdgeId edge_id : hierarchy_edges) {
+        UnpackEdge(edge_id, edges);
+    }
+
+    return RouteInfo{*best_weight, std::move(edges)};
+}
+
+/**
+ * Извлекает вершину из очереди и релаксирует её ребра search_arcs в одном направлении поиска.
+ * Если вершина достигнута и встречным поиском - обновляет лучший найденный маршрут.
+ * Вершина не продолжает поиск, если до неё есть более короткий путь через вершину большего
+ * ранга по ребрам stall_arcs: кратчайшие маршруты через неё всё равно пройдут иначе
+*/
+template <typename Weight>
+void ContractionHierarchyRouter<Weight>::SearchStep(SearchState& state, const SearchState& other_state,
+    const ArcsList& search_arcs, const ArcsList& stall_arcs,
+    std::optional<Weight>& best_weight, VertexId& meeting_vertex) {
+    const auto [weight, vertex] = state.queue.top();
+    state.queue.pop();
+    if (*state.weights[vertex] < weight) {
+        return;
+    }
+
+    if (other_state.weights[vertex]) {
+        const Weight route_weight = weight + *other_state.weights[vertex];
+        if (!best_weight || route_weight < *best_weight) {
+            best_weight = route_weight;
+            meeting_vertex = vertex;
+        }
+    }
+
+    for (size_t pos = stall_arcs.offsets[vertex]; pos < stall_arcs.offsets[vertex + 1]; ++pos) {
+        const Arc& arc = stall_arcs.arcs[pos];
+        const auto& weight_from = state.weights[arc.vertex];
+        if (weight_from && *weight_from + arc.weight < weight) {
+            return;
+        }
+    }
+
+    for (size_t pos = search_arcs.offsets[vertex]; pos < search_arcs.offsets[vertex + 1]; ++pos) {
+        const Arc& arc = search_arcs.arcs[pos];
+        const Weight candidate_weight = weight + arc.weight;
+        auto& weight_to = state.weights[arc.vertex];
+        if (!weight_to || candidate_weight < *weight_to) {
+            weight_to = candidate_weight;
+            state.prev_edges[arc.vertex] = arc.edge_id;
+            state.queue.push({candidate_weight, arc.vertex});
+        }
+    }
+}
+
+template <typename Weight>
+VertexId ContractionHierarchyRouter<Weight>::GetEdgeFrom(EdgeId edge_id) const {
+    return edge_id < graph_.GetEdgeCount()
+        ? graph_.GetEdge(edge_id).from
+        : contraction_data_.shortcuts[edge_id - graph_.GetEdgeCount()].from;
+}
+
+template <typename Weight>
+VertexId ContractionHierarchyRouter<Weight>::GetEdgeTo(EdgeId edge_id) const {
+    return edge_id < graph_.GetEdgeCount()
+        ? graph_.GetEdge(edge_id).to
+        : contraction_data_.shortcuts[edge_id - graph_.GetEdgeCount()].to;
+}
+
+/**
+ * Дописывает в edges исходные ребра графа, из которых состоит ребро иерархии edge_id
+*/
+template <typename Weight>
+void ContractionHierarchyRouter<Weight>::UnpackEdge(EdgeId edge_id, std::vector<EdgeId>& edges) const {
+    std::vector<EdgeId> stack{edge_id};
+    while (!stack.empty()) {
+        const EdgeId current = stack.back();
+        stack.pop_back();
+
+        if (current < graph_.GetEdgeCount()) {
+            edges.push_back(current);
+            continue;
+        }
+        const Shortcut& shortcut = contraction_data_.shortcuts[current - graph_.GetEdgeCount()];
+        stack.push_back(shortcut.second_edge);
+        stack.push_back(shortcut.first_edge);
+    }
+}
+
+}  // namespace graph
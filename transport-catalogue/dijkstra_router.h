@@ -0,0 +1,302 @@
+#pragma once
+
+#include "graph.h"
+#include "radix_heap.h"
+#include "router.h"
+
+#include <algorithm>
+#include <functional>
+#include <optional>
+#include <queue>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+/**
+ * Маршрутизатор, строящий маршрут алгоритмом Дейкстры в момент запроса.
+ * В отличие от Router не требует предварительного расчета маршрутов
+ * между всеми парами вершин. С потенциалом - нижней оценкой веса пути до цели -
+ * работает как A*
+*/
+template <typename Weight>
+class DijkstraRouter {
+private:
+    using Graph = DirectedWeightedGraph<Weight>;
+
+public:
+    using RouteInfo = typename Router<Weight>::RouteInfo;
+
+    /**
+     * Статистика поиска маршрута
+    */
+    struct SearchStats {
+        size_t settled_vertices = 0; // Число вершин, извлеченных из очереди с окончательным весом
+    };
+
+    explicit DijkstraRouter(const Graph& graph);
+
+    std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to, SearchStats* stats = nullptr) const;
+    template <typename Potential>
+    std::optional<RouteInfo> BuildRouteWithPotential(VertexId from, VertexId to,
+        const Potential& potential, SearchStats* stats = nullptr) const;
+    std::vector<std::optional<RouteInfo>> BuildRoutes(VertexId from, const std::vector<VertexId>& targets,
+        SearchStats* stats = nullptr) const;
+    std::vector<std::pair<VertexId, Weight>> BuildReachable(VertexId from, Weight max_weight,
+        SearchStats* stats = nullptr) const;
+
+private:
+    // Элемент очереди с приоритетом: вес пути до вершины с потенциалом вершины и сама вершина
+    using QueueItem = std::pair<Weight, VertexId>;
+    // Ключи, извлекаемые поиском из очереди, не убывают, поэтому при беззнаковых целых весах
+    // вместо двоичной кучи используется монотонная поразрядная очередь без сравнений элементов
+    using Queue = std::conditional_t<std::is_unsigned_v<Weight>,
+        RadixHeap<Weight, VertexId>,
+        std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>>>;
+
+    static constexpr Weight ZERO_WEIGHT{};
+    const Graph& graph_;
+
+    std::vector<EdgeId> RestoreEdges(const std::vector<std::optional<EdgeId>>& prev_edges, VertexId to) const;
+};
+
+template <typename Weight>
+DijkstraRouter<Weight>::DijkstraRouter(const Graph& graph)
+    : graph_(graph)
+{
+    for (const auto& edge : graph_.GetEdges()) {
+        if (edge.weight < ZERO_WEIGHT) {
+            throw std::domain_error("Edges' weights should be non-negative");
+        }
+    }
+}
+
+template <typename Weight>
+std::optional<typename DijkstraRouter<Weight>::RouteInfo> DijkstraRouter<Weight>::BuildRoute(
+    VertexId from, VertexId to, SearchStats* stats) const {
+    return BuildRouteWithPotential(from, to, [](VertexId) { return ZERO_WEIGHT; }, stats);
+}
+
+/**
+ * Строит маршрут алгоритмом A*: вершины извлекаются из очереди в порядке суммы веса пути
+ * и потенциала potential(vertex). Потенциал должен быть согласованным - для каждого
+ * ребра u -> v potential(u) <= weight + potential(v), тогда найденный маршрут кратчайший.
+ * При беззнаковых целых весах несогласованный потенциал приводит к исключению очереди
+*/
+template <typename Weight>
+template <typename Potential>
+std::optional<typename DijkstraRouter<Weight>::RouteInfo> DijkstraRouter<Weight>::BuildRouteWithPotential(
+    VertexId from, VertexId to, const Potential& potential, SearchStats* stats) const {
+    const size_t vertex_count = graph_.GetVertexCount();
+    if (from >= vertex_count || to >= vertex_count) {
+        throw std::out_of_range("Vertex id is out of range");
+    }
+
+    // Состояние поиска хранится локально, поэтому метод можно вызывать конкурентно
+    std::vector<std::optional<Weight>> weights(vertex_count);
+    std::vector<std::optional<EdgeId>> prev_edges(vertex_count);
+    std::vector<bool> settled(vertex_count, false);
+
+    Queue queue;
+    weights[from] = ZERO_WEIGHT;
+    queue.push({potential(from), from});
+    size_t settled_count = 0;
+
+    while (!queue.empty()) {
+        const VertexId vertex = queue.top().second;
+        queue.pop();
+
+        if (settled[vertex]) {
+            continue;
+        }
+        settled[vertex] = true;
+        ++settled_count;
+        const Weight weight = *weights[vertex];
+
+        // Вес до целевой вершины окончателен с момента её извлечения из очереди
+        if (vertex == to) {
+            break;
+        }
+
+        for (const EdgeId edge_id : graph_.GetIncidentEdges(vertex)) {
+            const auto& edge = graph_.GetEdge(edge_id);
+            if (settled[edge.to]) {
+                continue;
+            }
+            const Weight candidate_weight = weight + edge.weight;
+            auto& weight_to = weights[edge.to];
+            if (!weight_to || candidate_weight < *weight_to) {
+                weight_to = candidate_weight;
+                prev_edges[edge.to] = edge_id;
+                queue.push({candidate_weight + potential(edge.to), edge.to});
+            }
+        }
+    }
+
+    if (stats != nullptr) {
+        stats->settled_vertices = settled_count;
+    }
+
+    if (!weights[to]) {
+        return std::nullopt;
+    }
+
+    return RouteInfo{*weights[to], RestoreEdges(prev_edges, to)};
+}
+
+/**
+ * Строит маршруты из from до каждой из вершин targets одним деревом кратчайших путей:
+ * поиск останавливается, когда извлечены все целевые вершины. Возвращает маршруты
+ * в порядке targets, nullopt - для недостижимых вершин
+*/
+template <typename Weight>
+std::vector<std::optional<typename DijkstraRouter<Weight>::RouteInfo>> DijkstraRouter<Weight>::BuildRoutes(
+    VertexId from, const std::vector<VertexId>& targets, SearchStats* stats) const {
+    const size_t vertex_count = graph_.GetVertexCount();
+    if (from >= vertex_count) {
+        throw std::out_of_range("Vertex id is out of range");
+    }
+
+    // Отмечаем целевые вершины, повторы считаем один раз
+    std::vector<bool> is_target(vertex_count, false);
+    size_t targets_left = 0;
+    for (const VertexId target : targets) {
+        if (target >= vertex_count) {
+            throw std::out_of_range("Vertex id is out of range");
+        }
+        if (!is_target[target]) {
+            is_target[target] = true;
+            ++targets_left;
+        }
+    }
+
+    std::vector<std::optional<Weight>> weights(vertex_count);
+    std::vector<std::optional<EdgeId>> prev_edges(vertex_count);
+    std::vector<bool> settled(vertex_count, false);
+
+    Queue queue;
+    weights[from] = ZERO_WEIGHT;
+    queue.push({ZERO_WEIGHT, from});
+    size_t settled_count = 0;
+
+    while (!queue.empty() && targets_left > 0) {
+        const VertexId vertex = queue.top().second;
+        queue.pop();
+
+        if (settled[vertex]) {
+            continue;
+        }
+        settled[vertex] = true;
+        ++settled_count;
+        const Weight weight = *weights[vertex];
+
+        if (is_target[vertex]) {
+            --targets_left;
+        }
+
+        for (const EdgeId edge_id : graph_.GetIncidentEdges(vertex)) {
+            const auto& edge = graph_.GetEdge(edge_id);
+            if (settled[edge.to]) {
+                continue;
+            }
+            const Weight candidate_weight = weight + edge.weight;
+            auto& weight_to = weights[edge.to];
+            if (!weight_to || candidate_weight < *weight_to) {
+                weight_to = candidate_weight;
+                prev_edges[edge.to] = edge_id;
+                queue.push({candidate_weight, edge.to});
+            }
+        }
+    }
+
+    if (stats != nullptr) {
+        stats->settled_vertices = settled_count;
+    }
+
+    std::vector<std::optional<RouteInfo>> routes;
+    routes.reserve(targets.size());
+    for (const VertexId target : targets) {
+        if (!weights[target]) {
+            routes.emplace_back(std::nullopt);
+        }
+        else {
+            routes.emplace_back(RouteInfo{*weights[target], RestoreEdges(prev_edges, target)});
+        }
+    }
+    return routes;
+}
+
+/**
+ * Возвращает вершины, достижимые из from путем весом не больше max_weight, с весами путей
+ * в порядке их неубывания. Состояние поиска хранится в хэш-таблицах, поэтому затраты
+ * зависят от числа просмотренных вершин, а не от размера графа
+*/
+template <typename Weight>
+std::vector<std::pair<VertexId, Weight>> DijkstraRouter<Weight>::BuildReachable(
+    VertexId from, Weight max_weight, SearchStats* stats) const {
+    if (from >= graph_.GetVertexCount()) {
+        throw std::out_of_range("Vertex id is out of range");
+    }
+
+    std::unordered_map<VertexId, Weight> weights;
+    std::vector<std::pair<VertexId, Weight>> reachable;
+
+    Queue queue;
+    weights[from] = ZERO_WEIGHT;
+    queue.push({ZERO_WEIGHT, from});
+
+    // Вершины извлекаются в порядке неубывания веса, поэтому первая вершина
+    // тяжелее max_weight завершает поиск
+    while (!queue.empty() && !(max_weight < queue.top().first)) {
+        const auto [weight, vertex] = queue.top();
+        queue.pop();
+
+        // Устаревший элемент очереди - вершина уже извлечена с меньшим весом. Вес извлеченной
+        // вершины больше не уменьшается, поэтому каждая вершина извлекается один раз
+        if (weights.at(vertex) < weight) {
+            continue;
+        }
+        reachable.emplace_back(vertex, weight);
+
+        for (const EdgeId edge_id : graph_.GetIncidentEdges(vertex)) {
+            const auto& edge = graph_.GetEdge(edge_id);
+            const Weight candidate_weight = weight + edge.weight;
+            if (max_weight < candidate_weight) {
+                continue;
+            }
+            const auto [it, is_new] = weights.emplace(edge.to, candidate_weight);
+            if (is_new || candidate_weight < it->second) {
+                it->second = candidate_weight;
+                queue.push({candidate_weight, edge.to});
+            }
+        }
+    }
+
+    if (stats != nullptr) {
+        stats->settled_vertices = reachable.size();
+    }
+
+    return reachable;
+}
+
+/**
+ * Восстанавливает ребра маршрута до вершины to по предшествующим ребрам
+*/
+template <typename Weight>
+std::vector<EdgeId> DijkstraRouter<Weight>::RestoreEdges(
+    const std::vector<std::optional<EdgeId>>& prev_edges, VertexId to) const {
+    std::vector<EdgeId> edges;
+    for (std::optional<EdgeId> edge_id = prev_edges[to];
+         edge_id;
+         edge_id = prev_edges[graph_.GetEdge(*edge_id).from])
+    {
+        edges.push_back(*edge_id);
+    }
+    std::reverse(edges.begin(), edges.end());
+    return edges;
+}
+
+}  // namespace graph
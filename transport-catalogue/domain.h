@@ -17,11 +17,13 @@ struct Stop {
 
 /**
  * Структура "маршрут", содержит: номер маршрута, вектор указателей на остановки
+ * и время отправления рейсов с первой остановки (мин от начала суток)
 */
 struct Route {
 	std::string number;
 	bool is_round;
 	std::vector<Stop*> stops;
+	std::vector<double> departures = {};
 };
 
 /**
@@ -3,6 +3,7 @@
 #include "ranges.h"
 
 #include <cstdlib>
+#include <stdexcept>
 #include <vector>
 
 namespace graph {
@@ -17,6 +18,14 @@ struct Edge {
     Weight weight;
 };
 
+/**
+ * Ориентированный взвешенный граф. Пока граф заполняется, у каждой вершины свой список
+ * исходящих ребер; Freeze() однократно переводит граф в сжатое представление (CSR):
+ * массив смещений по вершинам и общий массив id ребер, упорядоченный по вершине-источнику.
+ * Для замороженного графа можно дополнительно построить такое же представление
+ * входящих ребер (BuildReverseIncidence), нужное поиску от конечной вершины.
+ * Unfreeze() возвращает граф к спискам ребер, чтобы добавить новые вершины и ребра
+*/
 template <typename Weight>
 class DirectedWeightedGraph {
 private:
@@ -25,22 +34,40 @@ private:
 
 public:
     DirectedWeightedGraph() = default;
-    DirectedWeightedGraph(const std::vector<Edge<Weight>>& edges, 
-        const std::vector<IncidenceList>& incidence_lists);
+    DirectedWeightedGraph(std::vector<Edge<Weight>> edges, std::vector<size_t> incidence_offsets,
+        std::vector<EdgeId> incidence_edges);
     explicit DirectedWeightedGraph(size_t vertex_count);
     EdgeId AddEdge(const Edge<Weight>& edge);
+    void AddVertexes(size_t count);
+    void SetEdgeWeight(EdgeId edge_id, Weight weight);
+    void Freeze();
+    void Unfreeze();
+    void BuildReverseIncidence();
 
+    bool IsFrozen() const;
+    bool HasReverseIncidence() const;
     size_t GetVertexCount() const;
     size_t GetEdgeCount() const;
     const Edge<Weight>& GetEdge(EdgeId edge_id) const;
     IncidentEdgesRange GetIncidentEdges(VertexId vertex) const;
+    IncidentEdgesRange GetIncomingEdges(VertexId vertex) const;
 
     const std::vector<Edge<Weight>>& GetEdges() const;
-    const std::vector<IncidenceList>& GetIncidenceLists() const;
+    const std::vector<size_t>& GetIncidenceOffsets() const;
+    const std::vector<EdgeId>& GetIncidenceEdges() const;
 
 private:
     std::vector<Edge<Weight>> edges_;
-    std::vector<IncidenceList> incidence_lists_;
+    std::vector<IncidenceList> incidence_lists_; // Списки ребер вершин до заморозки графа
+
+    // Сжатое представление: ребра вершины v - incidence_edges_[incidence_offsets_[v], incidence_offsets_[v + 1])
+    std::vector<size_t> incidence_offsets_;
+    std::vector<EdgeId> incidence_edges_;
+    bool is_frozen_ = false;
+
+    // Сжатое представление входящих ребер, упорядоченных по конечной вершине
+    std::vector<size_t> reverse_offsets_;
+    std::vector<EdgeId> reverse_edges_;
 };
 
 template <typename Weight>
@@ -49,23 +76,143 @@ DirectedWeightedGraph<Weight>::DirectedWeightedGraph(size_t vertex_count)
 }
 
 template <typename Weight>
-DirectedWeightedGraph<Weight>::DirectedWeightedGraph(
-    const std::vector<Edge<Weight>>& edges, const std::vector<IncidenceList>& incidence_lists)
-    : edges_(edges)
-    , incidence_lists_(incidence_lists)
-{}
+DirectedWeightedGraph<Weight>::DirectedWeightedGraph(std::vector<Edge<Weight>> edges,
+    std::vector<size_t> incidence_offsets, std::vector<EdgeId> incidence_edges)
+    : edges_(std::move(edges))
+    , incidence_offsets_(std::move(incidence_offsets))
+    , incidence_edges_(std::move(incidence_edges))
+    , is_frozen_(true)
+{
+    if (incidence_offsets_.empty()) {
+        incidence_offsets_.push_back(0);
+    }
+    if (incidence_offsets_.back() != incidence_edges_.size()
+        || incidence_edges_.size() != edges_.size()) {
+        throw std::invalid_argument("Incidence data doesn't match the edges");
+    }
+}
 
 template <typename Weight>
 EdgeId DirectedWeightedGraph<Weight>::AddEdge(const Edge<Weight>& edge) {
+    if (is_frozen_) {
+        throw std::logic_error("Can't add an edge to a frozen graph");
+    }
     edges_.push_back(edge);
     const EdgeId id = edges_.size() - 1;
     incidence_lists_.at(edge.from).push_back(id);
     return id;
 }
 
+template <typename Weight>
+void DirectedWeightedGraph<Weight>::AddVertexes(size_t count) {
+    if (is_frozen_) {
+        throw std::logic_error("Can't add vertexes to a frozen graph");
+    }
+    incidence_lists_.resize(incidence_lists_.size() + count);
+}
+
+/**
+ * Задает вес ребра. Топология графа не меняется, поэтому вес можно менять и после заморозки
+*/
+template <typename Weight>
+void DirectedWeightedGraph<Weight>::SetEdgeWeight(EdgeId edge_id, Weight weight) {
+    edges_.at(edge_id).weight = weight;
+}
+
+template <typename Weight>
+void DirectedWeightedGraph<Weight>::Freeze() {
+    if (is_frozen_) {
+        return;
+    }
+
+    // Сортировка подсчетом по вершине-источнику; внутри вершины ребра
+    // остаются в порядке добавления, как и в списках
+    const size_t vertex_count = incidence_lists_.size();
+    incidence_offsets_.assign(vertex_count + 1, 0);
+    for (const auto& edge : edges_) {
+        ++incidence_offsets_[edge.from + 1];
+    }
+    for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+        incidence_offsets_[vertex + 1] += incidence_offsets_[vertex];
+    }
+
+    incidence_edges_.resize(edges_.size());
+    std::vector<size_t> positions(incidence_offsets_.begin(), incidence_offsets_.end() - 1);
+    for (EdgeId edge_id = 0; edge_id < edges_.size(); ++edge_id) {
+        incidence_edges_[positions[edges_[edge_id].from]++] = edge_id;
+    }
+
+    incidence_lists_.clear();
+    incidence_lists_.shrink_to_fit();
+    is_frozen_ = true;
+}
+
+/**
+ * Переводит замороженный граф обратно в списки ребер вершин. Порядок ребер вершины
+ * сохраняется, списки входящих ребер удаляются и строятся заново после заморозки
+*/
+template <typename Weight>
+void DirectedWeightedGraph<Weight>::Unfreeze() {
+    if (!is_frozen_) {
+        return;
+    }
+
+    const size_t vertex_count = incidence_offsets_.size() - 1;
+    incidence_lists_.assign(vertex_count, {});
+    for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+        incidence_lists_[vertex].assign(incidence_edges_.begin() + incidence_offsets_[vertex],
+                                        incidence_edges_.begin() + incidence_offsets_[vertex + 1]);
+    }
+
+    incidence_offsets_.clear();
+    incidence_offsets_.shrink_to_fit();
+    incidence_edges_.clear();
+    incidence_edges_.shrink_to_fit();
+    reverse_offsets_.clear();
+    reverse_offsets_.shrink_to_fit();
+    reverse_edges_.clear();
+    reverse_edges_.shrink_to_fit();
+    is_frozen_ = false;
+}
+
+template <typename Weight>
+void DirectedWeightedGraph<Weight>::BuildReverseIncidence() {
+    if (!is_frozen_) {
+        throw std::logic_error("Reverse incidence requires a frozen graph");
+    }
+    if (HasReverseIncidence()) {
+        return;
+    }
+
+    const size_t vertex_count = GetVertexCount();
+    reverse_offsets_.assign(vertex_count + 1, 0);
+    for (const auto& edge : edges_) {
+        ++reverse_offsets_[edge.to + 1];
+    }
+    for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+        reverse_offsets_[vertex + 1] += reverse_offsets_[vertex];
+    }
+
+    reverse_edges_.resize(edges_.size());
+    std::vector<size_t> positions(reverse_offsets_.begin(), reverse_offsets_.end() - 1);
+    for (EdgeId edge_id = 0; edge_id < edges_.size(); ++edge_id) {
+        reverse_edges_[positions[edges_[edge_id].to]++] = edge_id;
+    }
+}
+
+template <typename Weight>
+bool DirectedWeightedGraph<Weight>::IsFrozen() const {
+    return is_frozen_;
+}
+
+template <typename Weight>
+bool DirectedWeightedGraph<Weight>::HasReverseIncidence() const {
+    return !reverse_offsets_.empty();
+}
+
 template <typename Weight>
 size_t DirectedWeightedGraph<Weight>::GetVertexCount() const {
-    return incidence_lists_.size();
+    return is_frozen_ ? incidence_offsets_.size() - 1 : incidence_lists_.size();
 }
 
 template <typename Weight>
@@ -81,17 +228,31 @@ const Edge<Weight>& DirectedWeightedGraph<Weight>::GetEdge(EdgeId edge_id) const
 template <typename Weight>
 typename DirectedWeightedGraph<Weight>::IncidentEdgesRange
 DirectedWeightedGraph<Weight>::GetIncidentEdges(VertexId vertex) const {
+    if (is_frozen_) {
+        return {incidence_edges_.begin() + incidence_offsets_[vertex],
+                incidence_edges_.begin() + incidence_offsets_[vertex + 1]};
+    }
     return ranges::AsRange(incidence_lists_.at(vertex));
 }
 
+template <typename Weight>
+typename DirectedWeightedGraph<Weight>::IncidentEdgesRange
+DirectedWeightedGraph<Weight>::GetIncomingEdges(VertexId vertex) const {
+    return {reverse_edges_.begin() + reverse_offsets_[vertex],
+            reverse_edges_.begin() + reverse_offsets_[vertex + 1]};
+}
+
 template <typename Weight>
 const std::vector<Edge<Weight>>& DirectedWeightedGraph<Weight>::GetEdges() const {
     return edges_;
 }
 template <typename Weight>
-const std::vector<typename DirectedWeightedGraph<Weight>::IncidenceList>& 
-    DirectedWeightedGraph<Weight>::GetIncidenceLists() const {
-    return incidence_lists_;
+const std::vector<size_t>& DirectedWeightedGraph<Weight>::GetIncidenceOffsets() const {
+    return incidence_offsets_;
+}
+template <typename Weight>
+const std::vector<EdgeId>& DirectedWeightedGraph<Weight>::GetIncidenceEdges() const {
+    return incidence_edges_;
 }
 
 }  // namespace graph
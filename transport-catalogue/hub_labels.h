@@ -0,0 +1,345 @@
+#pragma once
+
+#include "graph.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+/**
+ * Индекс меток-хабов (Hub Labeling) для поиска веса кратчайшего пути без самого пути.
+ * Каждой вершине сопоставляются прямая метка - хабы, достижимые из неё, с весами путей до них,
+ * и обратная метка - хабы, из которых достижима она. Кратчайший путь from -> to проходит
+ * через общий хаб прямой метки from и обратной метки to, поэтому запрос - слияние двух
+ * отсортированных массивов. Метки строятся отсеченными поисками Дейкстры
+ * (Pruned Landmark Labeling) от вершин в порядке убывания их важности
+*/
+template <typename Weight>
+class HubLabels {
+private:
+    using Graph = DirectedWeightedGraph<Weight>;
+
+public:
+    /**
+     * Метки всех вершин, достаточные для создания индекса без повторного расчета.
+     * Метка вершины v - элементы [offsets[v], offsets[v + 1]) массивов hubs и weights,
+     * хаб задается номером вершины в порядке order, метки упорядочены по нему
+    */
+    struct Labels {
+        std::vector<uint32_t> offsets;
+        std::vector<uint32_t> hubs;
+        std::vector<Weight> weights;
+    };
+    struct LabelsData {
+        std::vector<VertexId> order; // Вершины в порядке убывания важности
+        Labels forward_labels;
+        Labels backward_labels;
+    };
+
+    static constexpr Weight INFINITE_WEIGHT = std::numeric_limits<Weight>::max();
+
+    explicit HubLabels(const Graph& graph);
+    HubLabels(const Graph& graph, LabelsData labels_data);
+
+    std::optional<Weight> GetWeight(VertexId from, VertexId to) const;
+    const LabelsData& GetLabelsData() const;
+
+private:
+    using QueueItem = std::pair<Weight, VertexId>;
+    using Queue = std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>>;
+    // Метка вершины во время построения: пары номер хаба - вес пути
+    using BuildLabel = std::vector<std::pair<uint32_t, Weight>>;
+
+    static constexpr Weight ZERO_WEIGHT{};
+    static constexpr size_t SAMPLE_COUNT = 64; // Число деревьев кратчайших путей для оценки важности
+
+    LabelsData labels_data_;
+
+    void OrderVertexes(const Graph& graph);
+    void BuildLabels(const Graph& graph);
+    static void AddPrunedLabels(const Graph& graph, uint32_t hub, VertexId root,
+        const std::vector<BuildLabel>& root_labels, std::vector<BuildLabel>& reached_labels,
+        std::vector<Weight>& weights, std::vector<Weight>& root_hub_weights);
+    static Labels FlattenLabels(const std::vector<BuildLabel>& labels);
+    static bool IsValid(const Labels& labels, size_t vertex_count);
+};
+
+template <typename Weight>
+HubLabels<Weight>::HubLabels(const Graph& graph) {
+    if (graph.GetVertexCount() >= std::numeric_limits<uint32_t>::max()) {
+        throw std::length_error("Too many vertices for hub labels");
+    }
+    for (const auto& edge : graph.GetEdges()) {
+        if (edge.weight < ZERO_WEIGHT) {
+            throw std::domain_error("Edges' weights should be non-negative");
+        }
+    }
+    OrderVertexes(graph);
+    BuildLabels(graph);
+}
+
+template <typename Weight>
+HubLabels<Weight>::HubLabels(const Graph& graph, LabelsData labels_data)
+    : labels_data_(std::move(labels_data))
+{
+    const size_t vertex_count = graph.GetVertexCount();
+    if (labels_data_.order.size() != vertex_count
+        || !IsValid(labels_data_.forward_labels, vertex_count)
+        || !IsValid(labels_data_.backward_labels, vertex_count)) {
+        throw std::invalid_argument("Hub labels don't match the graph");
+    }
+}
+
+/**
+ * Возвращает вес кратчайшего пути от from до to, либо nullopt, если пути нет
+*/
+template <typename Weight>
+std::optional<Weight> HubLabels<Weight>::GetWeight(VertexId from, VertexId to) const {
+    const Labels& forward = labels_data_.forward_labels;
+    const Labels& backward = labels_data_.backward_labels;
+    if (from + 1 >= forward.offsets.size() || to + 1 >= backward.offsets.size()) {
+        throw std::out_of_range("Vertex id is out of range");
+    }
+
+    uint32_t forward_pos = forward.offsets[from];
+    const uint32_t forward_end = forward.offsets[from + 1];
+    uint32_t backward_pos = backward.offsets[to];
+    const uint32_t backward_end = backward.offsets[to + 1];
+
+    Weight weight = INFINITE_WEIGHT;
+    while (forward_pos < forward_end && backward_pos < backward_end) {
+        const uint32_t forward_hub = forward.hubs[forward_pos];
+        const uint32_t backward_hub = backward.hubs[backward_pos];
+        if (forward_hub < backward_hub) {
+            ++forward_pos;
+        }
+        else if (backward_hub < forward_hub) {
+            ++backward_pos;
+        }
+        else {
+            weight = std::min(weight, forward.weights[forward_pos++] + backward.weights[backward_pos++]);
+        }
+    }
+
+    if (weight == INFINITE_WEIGHT) {
+        return std::nullopt;
+    }
+    return weight;
+}
+
+template <typename Weight>
+const typename HubLabels<Weight>::LabelsData& HubLabels<Weight>::GetLabelsData() const {
+    return labels_data_;
+}
+
+/**
+ * Упорядочивает вершины по убыванию важности. Важность вершины - суммарное число потомков
+ * в деревьях кратчайших путей от SAMPLE_COUNT равномерно выбранных вершин: через вершины
+ * пересадок с большим числом потомков проходит больше кратчайших путей, и ранний выбор их
+ * хабами сильнее отсекает последующие поиски. Вершины с равной важностью идут в порядке id
+*/
+template <typename Weight>
+void HubLabels<Weight>::OrderVertexes(const Graph& graph) {
+    const size_t vertex_count = graph.GetVertexCount();
+    std::vector<size_t> importances(vertex_count, 0);
+    std::vector<Weight> weights(vertex_count);
+    std::vector<VertexId> parents(vertex_count);
+    std::vector<size_t> descendants(vertex_count);
+    std::vector<VertexId> settled_order;
+    settled_order.reserve(vertex_count);
+
+    const size_t sample_count = std::min(SAMPLE_COUNT, vertex_count);
+    for (size_t sample = 0; sample < sample_count; ++sample) {
+        const VertexId root = sample * vertex_count / sample_count;
+        std::fill(weights.begin(), weights.end(), INFINITE_WEIGHT);
+        std::fill(parents.begin(), parents.end(), root);
+        settled_order.clear();
+
+        Queue queue;
+        weights[root] = ZERO_WEIGHT;
+        queue.push({ZERO_WEIGHT, root});
+        while (!queue.empty()) {
+            const auto [weight, vertex] = queue.top();
+            queue.pop();
+            if (weights[vertex] < weight) {
+                continue;
+            }
+            settled_order.push_back(vertex);
+            for (const EdgeId edge_id : graph.GetIncidentEdges(vertex)) {
+                const auto& edge = graph.GetEdge(edge_id);
+                if (weight + edge.weight < weights[edge.to]) {
+                    weights[edge.to] = weight + edge.weight;
+                    parents[edge.to] = vertex;
+                    queue.push({weights[edge.to], edge.to});
+                }
+            }
+        }
+
+        // Вершины извлекаются после своих предков, поэтому потомки считаются обратным проходом
+        for (const VertexId vertex : settled_order) {
+            descendants[vertex] = 1;
+        }
+        for (auto it = settled_order.rbegin(); it != settled_order.rend(); ++it) {
+            if (*it != root) {
+                descendants[parents[*it]] += descendants[*it];
+            }
+            importances[*it] += descendants[*it];
+        }
+    }
+
+    auto& order = labels_data_.order;
+    order.resize(vertex_count);
+    for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+        order[vertex] = vertex;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](VertexId lhs, VertexId rhs) {
+        return importances[lhs] > importances[rhs];
+    });
+}
+
+/**
+ * Строит метки: для каждой вершины в порядке order выполняются прямой и обратный отсеченные
+ * поиски, добавляющие её хабом в метки достигнутых вершин. Хабы добавляются
+ * по возрастанию номера, поэтому метки сразу упорядочены
+*/
+template <typename Weight>
+void HubLabels<Weight>::BuildLabels(const Graph& graph) {
+    const size_t vertex_count = graph.GetVertexCount();
+    std::vector<BuildLabel> forward_labels(vertex_count);
+    std::vector<BuildLabel> backward_labels(vertex_count);
+
+    // Списки входящих ребер для обратного поиска
+    Graph reverse_graph(vertex_count);
+    for (const auto& edge : graph.GetEdges()) {
+        reverse_graph.AddEdge({edge.to, edge.from, edge.weight});
+    }
+    reverse_graph.Freeze();
+
+    std::vector<Weight> weights(vertex_count, INFINITE_WEIGHT);
+    std::vector<Weight> root_hub_weights(vertex_count, INFINITE_WEIGHT);
+    for (uint32_t hub = 0; hub < vertex_count; ++hub) {
+        const VertexId root = labels_data_.order[hub];
+        // Прямой поиск находит пути от хаба: хаб входит в обратные метки достигнутых вершин
+        AddPrunedLabels(graph, hub, root, forward_labels, backward_labels, weights, root_hub_weights);
+        // Обратный поиск по развернутому графу находит пути до хаба
+        AddPrunedLabels(reverse_graph, hub, root, backward_labels, forward_labels, weights, root_hub_weights);
+    }
+
+    labels_data_.forward_labels = FlattenLabels(forward_labels);
+    labels_data_.backward_labels = FlattenLabels(backward_labels);
+}
+
+/**
+ * Поиск Дейкстры от root, добавляющий хаб hub в метки reached_labels достигнутых вершин.
+ * Вершина отсекается, если уже построенные метки дают путь не длиннее найденного:
+ * тогда кратчайшие пути через неё покрыты хабами большей важности.
+ * root_labels - метки того же направления, что и у root: прямые для прямого поиска
+*/
+template <typename Weight>
+void HubLabels<Weight>::AddPrunedLabels(const Graph& graph, uint32_t hub, VertexId root,
+    const std::vector<BuildLabel>& root_labels, std::vector<BuildLabel>& reached_labels,
+    std::vector<Weight>& weights, std::vector<Weight>& root_hub_weights) {
+    // Веса путей между root и хабами его метки - для проверки отсечения за размер метки вершины.
+    // К обратному поиску метка root уже содержит сам хаб, добавленный прямым поиском
+    for (const auto& [label_hub, weight] : root_labels[root]) {
+        root_hub_weights[label_hub] = weight;
+    }
+
+    std::vector<VertexId> touched;
+    Queue queue;
+    weights[root] = ZERO_WEIGHT;
+    touched.push_back(root);
+    queue.push({ZERO_WEIGHT, root});
+
+    while (!queue.empty()) {
+        const auto [weight, vertex] = queue.top();
+        queue.pop();
+        if (weights[vertex] < weight) {
+            continue;
+        }
+
+        bool is_covered = false;
+        for (const auto& [label_hub, label_weight] : reached_labels[vertex]) {
+            if (root_hub_weights[label_hub] != INFINITE_WEIGHT
+                && !(weight < root_hub_weights[label_hub] + label_weight)) {
+                is_covered = true;
+                break;
+            }
+        }
+        if (is_covered) {
+            continue;
+        }
+        reached_labels[vertex].push_back({hub, weight});
+
+        for (const EdgeId edge_id : graph.GetIncidentEdges(vertex)) {
+            const auto& edge = graph.GetEdge(edge_id);
+            const Weight candidate_weight = weight + edge.weight;
+            if (candidate_weight < weights[edge.to]) {
+                if (weights[edge.to] == INFINITE_WEIGHT) {
+                    touched.push_back(edge.to);
+                }
+                weights[edge.to] = candidate_weight;
+                queue.push({candidate_weight, edge.to});
+            }
+        }
+    }
+
+    for (const VertexId vertex : touched) {
+        weights[vertex] = INFINITE_WEIGHT;
+    }
+    for (const auto& [label_hub, weight] : root_labels[root]) {
+        root_hub_weights[label_hub] = INFINITE_WEIGHT;
+    }
+}
+
+template <typename Weight>
+typename HubLabels<Weight>::Labels HubLabels<Weight>::FlattenLabels(const std::vector<BuildLabel>& labels) {
+    Labels result;
+    result.offsets.reserve(labels.size() + 1);
+    result.offsets.push_back(0);
+    for (const auto& label : labels) {
+        for (const auto& [hub, weight] : label) {
+            result.hubs.push_back(hub);
+            result.weights.push_back(weight);
+        }
+        if (result.hubs.size() >= std::numeric_limits<uint32_t>::max()) {
+            throw std::length_error("Too many hub labels");
+        }
+        result.offsets.push_back(static_cast<uint32_t>(result.hubs.size()));
+    }
+    return result;
+}
+
+/**
+ * Проверяет, что метки заданы для vertex_count вершин и упорядочены по хабам
+*/
+template <typename Weight>
+bool HubLabels<Weight>::IsValid(const Labels& labels, size_t vertex_count) {
+    if (labels.offsets.size() != vertex_count + 1 || labels.offsets.front() != 0
+        || labels.offsets.back() != labels.hubs.size() || labels.hubs.size() != labels.weights.size()) {
+        return false;
+    }
+    for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+        if (labels.offsets[vertex] > labels.offsets[vertex + 1]) {
+            return false;
+        }
+        for (uint32_t pos = labels.offsets[vertex]; pos < labels.offsets[vertex + 1]; ++pos) {
+            if (labels.hubs[pos] >= vertex_count
+                || (pos > labels.offsets[vertex] && labels.hubs[pos] <= labels.hubs[pos - 1])) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+}  // namespace graph
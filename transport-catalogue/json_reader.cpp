@@ -1,9 +1,14 @@
 #include "json_builder.h"
 #include "json_reader.h"
 
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <limits>
 #include <set>
 #include <sstream>
 #include <string_view>
+#include <thread>
 #include <vector>
 
 namespace transport_catalogue {
@@ -71,6 +76,59 @@ void JsonIOHandler::ProcessMakeBaseRequests() {
 		}
 	}
 }
+/**
+ * Обрабатывает запросы на добавление маршрутов в десериализованную базу:
+ * маршруты вносятся в справочник, орграф и данные маршрутизатора обновляются без полного пересчета.
+ * Новые маршруты могут проходить только через остановки, уже имеющиеся в базе
+*/
+void JsonIOHandler::ProcessUpdateBaseRequests() {
+	if (!requests_) {
+		requests_ = json::Load(input_stream_);
+	}
+
+	// Если переданный документ не содержит словаря запросов, либо переданный
+	// словарь пуст - прерываем обработку запроса
+	if (!requests_.value().GetRoot().IsDict()) {
+		return;
+	}
+	const auto requests_it = requests_.value().GetRoot().AsDict().find("base_requests"s);
+	if (requests_it == requests_.value().GetRoot().AsDict().end()) {
+		return;
+	}
+	else if (!requests_it->second.IsArray()) {
+		throw invalid_argument("Insertation requests must be in array"s);
+	}
+
+	for (const json::Node& request_map : requests_it->second.AsArray()) {
+		// Если узел запроса не является словарем - выбрасываем исключение invalid_argument
+		if (!request_map.IsDict()) {
+			throw invalid_argument("Insertation request node must be map"s);
+		}
+
+		// Новые остановки изменили бы нумерацию вершин орграфа
+		if (request_map.AsDict().at("type"s) == "Stop"s) {
+			throw invalid_argument("Stops can't be added to an existing base"s);
+		}
+		else if (request_map.AsDict().at("type"s) != "Bus"s) {
+			continue;
+		}
+
+		if (catalogue_.FindRoute(request_map.AsDict().at("name"s).AsString()) != nullptr) {
+			throw invalid_argument("Route is already in the base"s);
+		}
+		const auto stops_it = request_map.AsDict().find("stops"s);
+		if (stops_it != request_map.AsDict().end() && stops_it->second.IsArray()) {
+			for (const json::Node& station : stops_it->second.AsArray()) {
+				if (catalogue_.FindStop(station.AsString()) == nullptr) {
+					throw invalid_argument("Unknown stop in the added route"s);
+				}
+			}
+		}
+		AddRoute(request_map.AsDict());
+	}
+
+	router_.AddNewRoutes();
+}
 /**
  * Обрыбытвает запросы на поиск в транспортном справочнике
 */
@@ -89,6 +147,16 @@ json::Document JsonIOHandler::ProcessStatsRequests() {
 		return output;
 	}
 
+	// Измененные настройки маршрутизации и настройки обработки должны быть применены до самих запросов
+	const auto routing_it = requests_.value().GetRoot().AsDict().find("routing_settings"s);
+	if (routing_it != requests_.value().GetRoot().AsDict().end()) {
+		ProcessRouteCustomization(routing_it->second);
+	}
+	const auto settings_it = requests_.value().GetRoot().AsDict().find("stat_settings"s);
+	if (settings_it != requests_.value().GetRoot().AsDict().end()) {
+		ProcessStatSettings(settings_it->second);
+	}
+
 	// Итерируемся по запросам, отправляем в соответствующие методы их содержание
 	for (const auto& [requests_type, requests] : requests_.value().GetRoot().AsDict()) {
 		if (requests_type == "stat_requests"s) {
@@ -203,10 +271,23 @@ void JsonIOHandler::AddRoute(const json::Dict& request_map) {
 		}
 	}
 
+	// Расписание задается опционально: время отправления рейсов с первой остановки, мин
+	vector<double> departures;
+	const auto departures_it = request_map.find("departures"s);
+	if (departures_it != request_map.end()) {
+		for (const json::Node& departure : departures_it->second.AsArray()) {
+			if (departure.AsDouble() < 0.0) {
+				throw invalid_argument("Departure time must be non-negative"s);
+			}
+			departures.push_back(departure.AsDouble());
+		}
+	}
+
 	catalogue_.AddRoute({
 			request_map.at("name"s).AsString(),
 			request_map.at("is_roundtrip"s).AsBool(),
-			stops
+			stops,
+			departures
 		});
 }
 
@@ -223,35 +304,98 @@ void JsonIOHandler::AddRoute(const json::Dict& request_map) {
 		return json::Document{};
 	}
 
-	json::Array results; // json-массив результатов поиска
+	const json::Array& requests_array = requests.AsArray();
+	// Результаты запросов на позициях самих запросов, nullopt - запрос неизвестного типа
+	vector<optional<json::Node>> results(requests_array.size());
 
-	// Итерируемся по словарям самих запросов
-	for (const json::Node& request_map : requests.AsArray()) {
-		// Если узел запроса не является словарем - выбрасываем исключение invalid_argument
-		if (!request_map.IsDict()) {
-			throw invalid_argument("Stat request node must be map"s);
+	const size_t threads_count = min(stat_threads_, requests_array.size());
+	if (threads_count <= 1) {
+		for (size_t i = 0; i < requests_array.size(); ++i) {
+			results[i] = ProcessStatRequest(requests_array[i]);
 		}
+	}
+	else {
+		// Потоки забирают запросы по одному, а результат записывают на позицию запроса,
+		// поэтому порядок ответов не зависит от распределения запросов по потокам
+		atomic<size_t> next_request = 0;
+		vector<exception_ptr> errors(requests_array.size());
 
-		if (request_map.AsDict().at("type"s) == "Stop"s) {
-			results.push_back(FindStop(request_map.AsDict()));
-		}
-		else if (request_map.AsDict().at("type"s) == "Bus"s) {
-			results.push_back(FindRoute(request_map.AsDict()));
+		auto worker = [&]() {
+			for (size_t i = next_request++; i < requests_array.size(); i = next_request++) {
+				try {
+					results[i] = ProcessStatRequest(requests_array[i]);
+				}
+				catch (...) {
+					errors[i] = current_exception();
+				}
+			}
+		};
+
+		vector<thread> threads;
+		threads.reserve(threads_count - 1);
+		for (size_t thread_index = 1; thread_index < threads_count; ++thread_index) {
+			threads.emplace_back(worker);
 		}
-		else if (request_map.AsDict().at("type"s) == "Map"s) {
-			results.push_back(RenderMap(request_map.AsDict()));
+		worker();
+		for (auto& thread : threads) {
+			thread.join();
 		}
-		else if (request_map.AsDict().at("type"s) == "Route"s) {
-			results.push_back(BuildRoute(request_map.AsDict()));
+
+		// Как и при последовательной обработке, выбрасываем ошибку первого по порядку запроса
+		for (const auto& error : errors) {
+			if (error) {
+				rethrow_exception(error);
+			}
 		}
-		/*
-		else {
-			throw invalid_argument("Unknown object type"s);
+	}
+
+	json::Array output; // json-массив результатов поиска
+	for (auto& result : results) {
+		if (result) {
+			output.push_back(std::move(result.value()));
 		}
-		*/
 	}
 
-	return json::Document(results);
+	return json::Document(output);
+}
+/**
+ * Обрабатывает один поисковый запрос, возвращает nullopt для запроса неизвестного типа.
+ * Не меняет состояние справочника, поэтому может вызываться конкурентно
+*/
+[[nodiscard]] optional<json::Node> JsonIOHandler::ProcessStatRequest(const json::Node& request_map) const {
+	// Если узел запроса не является словарем - выбрасываем исключение invalid_argument
+	if (!request_map.IsDict()) {
+		throw invalid_argument("Stat request node must be map"s);
+	}
+
+	if (request_map.AsDict().at("type"s) == "Stop"s) {
+		return FindStop(request_map.AsDict());
+	}
+	else if (request_map.AsDict().at("type"s) == "Bus"s) {
+		return FindRoute(request_map.AsDict());
+	}
+	else if (request_map.AsDict().at("type"s) == "Map"s) {
+		return RenderMap(request_map.AsDict());
+	}
+	else if (request_map.AsDict().at("type"s) == "Route"s) {
+		return BuildRoute(request_map.AsDict());
+	}
+	else if (request_map.AsDict().at("type"s) == "RouteMatrix"s) {
+		return BuildRouteMatrix(request_map.AsDict());
+	}
+	else if (request_map.AsDict().at("type"s) == "EarliestArrival"s) {
+		return BuildJourney(request_map.AsDict());
+	}
+	else if (request_map.AsDict().at("type"s) == "Isochrone"s) {
+		return BuildIsochrone(request_map.AsDict());
+	}
+	/*
+	else {
+		throw invalid_argument("Unknown object type"s);
+	}
+	*/
+
+	return nullopt;
 }
 
 /**
@@ -343,6 +487,30 @@ json::Node JsonIOHandler::FindRoute(const json::Dict& request_map) const {
  * Возвращает json-узел с информацией об оптимальном маршруте
 */
 [[nodiscard]] json::Node JsonIOHandler::BuildRoute(const json::Dict& request_map) const {
+	// Если нужно только время маршрута - маршрут не строится
+	const auto time_only_it = request_map.find("time_only"s);
+	if (time_only_it != request_map.end() && time_only_it->second.AsBool()) {
+		const auto time = router_.ComputeRouteTime(
+			request_map.at("from"s).AsString(), request_map.at("to"s).AsString()
+		);
+		json::Builder builder;
+		builder
+			.StartDict()
+				.Key("request_id"s)
+				.Value(request_map.at("id"s));
+		if (!time) {
+			builder
+				.Key("error_message"s)
+				.Value("not found"s);
+		}
+		else {
+			builder
+				.Key("total_time"s)
+				.Value(*time);
+		}
+		return builder.EndDict().Build();
+	}
+
 	// Строим маршрут в router_
 	const auto result = router_.BuildRoute(
 		request_map.at("from"s).AsString(), request_map.at("to"s).AsString()
@@ -360,21 +528,244 @@ json::Node JsonIOHandler::FindRoute(const json::Dict& request_map) const {
 			.Build();
 	}
 
+	json::Builder builder;
+	builder
+		.StartDict()
+			.Key("request_id"s)
+			.Value(request_map.at("id"s))
+			.Key("total_time"s)
+			.Value(result->time)
+			.Key("items"s)
+			.Value(GetRouteItems(result->items));
+
+	// Статистика поиска выводится только по запросу
+	const auto stats_it = request_map.find("stats"s);
+	if (stats_it != request_map.end() && stats_it->second.AsBool()) {
+		builder
+			.Key("settled_vertices"s)
+			.Value(static_cast<int>(result->settled_vertices));
+	}
+
+	return builder.EndDict().Build();
+}
+/**
+ * Возвращает json-узел с временами маршрутов от одной остановки до списка остановок
+*/
+[[nodiscard]] json::Node JsonIOHandler::BuildRouteMatrix(const json::Dict& request_map) const {
+	vector<string_view> stops_to;
+	for (const json::Node& stop_node : request_map.at("to"s).AsArray()) {
+		stops_to.push_back(stop_node.AsString());
+	}
+
+	// Если нужны только времена маршрутов - маршруты не строятся
+	const auto time_only_it = request_map.find("time_only"s);
+	if (time_only_it != request_map.end() && time_only_it->second.AsBool()) {
+		const auto times = router_.ComputeRouteTimes(request_map.at("from"s).AsString(), stops_to);
+
+		json::Array routes_array;
+		for (size_t i = 0; i < times.size(); ++i) {
+			json::Builder route_builder;
+			route_builder
+				.StartDict()
+					.Key("to"s)
+					.Value(string(stops_to[i]));
+			if (!times[i]) {
+				route_builder
+					.Key("error_message"s)
+					.Value("not found"s);
+			}
+			else {
+				route_builder
+					.Key("total_time"s)
+					.Value(*times[i]);
+			}
+			routes_array.push_back(route_builder.EndDict().Build());
+		}
+
+		return json::Builder{}
+			.StartDict()
+				.Key("request_id"s)
+				.Value(request_map.at("id"s))
+				.Key("routes"s)
+				.Value(routes_array)
+			.EndDict()
+			.Build();
+	}
+
+	// Строим все маршруты одним поиском в router_
+	const auto results = router_.BuildRoutes(request_map.at("from"s).AsString(), stops_to);
+
+	// Детали маршрутов и статистика поиска выводятся только по запросу
+	const auto items_it = request_map.find("items"s);
+	const bool is_items_needed = items_it != request_map.end() && items_it->second.AsBool();
+	const auto stats_it = request_map.find("stats"s);
+	const bool is_stats_needed = stats_it != request_map.end() && stats_it->second.AsBool();
+
+	json::Array routes_array;
+	size_t settled_vertices = 0;
+	for (size_t i = 0; i < results.size(); ++i) {
+		json::Builder route_builder;
+		route_builder
+			.StartDict()
+				.Key("to"s)
+				.Value(string(stops_to[i]));
+
+		if (!results[i]) {
+			route_builder
+				.Key("error_message"s)
+				.Value("not found"s);
+		}
+		else {
+			route_builder
+				.Key("total_time"s)
+				.Value(results[i]->time);
+			if (is_items_needed) {
+				route_builder
+					.Key("items"s)
+					.Value(GetRouteItems(results[i]->items));
+			}
+			settled_vertices = max(settled_vertices, results[i]->settled_vertices);
+		}
+
+		routes_array.push_back(route_builder.EndDict().Build());
+	}
+
+	json::Builder builder;
+	builder
+		.StartDict()
+			.Key("request_id"s)
+			.Value(request_map.at("id"s))
+			.Key("routes"s)
+			.Value(routes_array);
+
+	if (is_stats_needed) {
+		builder
+			.Key("settled_vertices"s)
+			.Value(static_cast<int>(settled_vertices));
+	}
+
+	return builder.EndDict().Build();
+}
+/**
+ * Возвращает json-узел с маршрутом по расписанию с самым ранним прибытием
+*/
+[[nodiscard]] json::Node JsonIOHandler::BuildJourney(const json::Dict& request_map) const {
+	// Число пересадок ограничивается опционально
+	size_t max_transfers = numeric_limits<size_t>::max();
+	const auto transfers_it = request_map.find("max_transfers"s);
+	if (transfers_it != request_map.end()) {
+		if (transfers_it->second.AsInt() < 0) {
+			throw invalid_argument("Max transfers count must be non-negative"s);
+		}
+		max_transfers = static_cast<size_t>(transfers_it->second.AsInt());
+	}
+
+	// Строим маршрут по расписанию в router_
+	const auto result = router_.BuildJourney(
+		request_map.at("from"s).AsString(), request_map.at("to"s).AsString(),
+		request_map.at("departure_time"s).AsDouble(), max_transfers
+	);
+
+	// Если такой маршрут не был найден - возвращаем шаблонный ответ
+	if (!result) {
+		return json::Builder{}
+			.StartDict()
+				.Key("request_id"s)
+				.Value(request_map.at("id"s))
+				.Key("error_message"s)
+				.Value("not found"s)
+			.EndDict()
+			.Build();
+	}
+
+	return json::Builder{}
+		.StartDict()
+			.Key("request_id"s)
+			.Value(request_map.at("id"s))
+			.Key("arrival_time"s)
+			.Value(result->arrival_time)
+			.Key("total_time"s)
+			.Value(result->arrival_time - result->departure_time)
+			.Key("items"s)
+			.Value(GetRouteItems(result->items))
+		.EndDict()
+		.Build();
+}
+/**
+ * Возвращает json-узел с остановками, достижимыми за ограниченное время
+*/
+[[nodiscard]] json::Node JsonIOHandler::BuildIsochrone(const json::Dict& request_map) const {
+	const double max_time = request_map.at("max_time"s).AsDouble();
+	if (max_time < 0.0) {
+		throw invalid_argument("Isochrone time must be non-negative"s);
+	}
+
+	const auto result = router_.BuildIsochrone(request_map.at("from"s).AsString(), max_time);
+
+	// Если остановка неизвестна - возвращаем шаблонный ответ
+	if (!result) {
+		return json::Builder{}
+			.StartDict()
+				.Key("request_id"s)
+				.Value(request_map.at("id"s))
+				.Key("error_message"s)
+				.Value("not found"s)
+			.EndDict()
+			.Build();
+	}
+
+	// Массив достижимых остановок
+	json::Array stops_array;
+	for (const auto& [stop_name, time] : result->stops) {
+		stops_array.push_back(json::Builder{}
+			.StartDict()
+				.Key("stop_name"s)
+				.Value(string(stop_name))
+				.Key("time"s)
+				.Value(time)
+			.EndDict()
+			.Build()
+		);
+	}
+
+	json::Builder builder;
+	builder
+		.StartDict()
+			.Key("request_id"s)
+			.Value(request_map.at("id"s))
+			.Key("stops"s)
+			.Value(stops_array);
+
+	// Статистика поиска выводится только по запросу
+	const auto stats_it = request_map.find("stats"s);
+	if (stats_it != request_map.end() && stats_it->second.AsBool()) {
+		builder
+			.Key("settled_vertices"s)
+			.Value(static_cast<int>(result->settled_vertices));
+	}
+
+	return builder.EndDict().Build();
+}
+/**
+ * Возвращает json-массив деталей маршрута
+*/
+[[nodiscard]] json::Array JsonIOHandler::GetRouteItems(const vector<RouteItem>& items) const {
 	// Массив деталей маршрута
 	json::Array items_array;
 
-	// Итерируемся по ребрам, формируем соответствующие словари 
-	// и вносим их в массив деталей маршрута
-	for (const auto& edge : result.value().edges) {
-		if (edge.type == EdgeType::STOP) {
+	// Итерируемся по элементам маршрута, формируем соответствующие словари 
+	// и вносим их в массив деталей маршрута. Названия остановок и маршрутов
+	// берутся из справочника по id только здесь
+	for (const auto& item : items) {
+		if (item.type == EdgeType::STOP) {
 			items_array.push_back(json::Builder{}
 				.StartDict()
 					.Key("type"s)
 					.Value("Wait"s)
 					.Key("stop_name"s)
-					.Value(string(edge.name))
+					.Value(string(router_.GetStopName(item.name_id)))
 					.Key("time"s)
-					.Value(edge.weight)
+					.Value(item.time)
 				.EndDict()
 				.Build()
 			);
@@ -385,27 +776,18 @@ json::Node JsonIOHandler::FindRoute(const json::Dict& request_map) const {
 					.Key("type"s)
 					.Value("Bus"s)
 					.Key("bus"s)
-					.Value(string(edge.name))
+					.Value(string(router_.GetRouteName(item.name_id)))
 					.Key("span_count"s)
-					.Value(static_cast<int>(edge.span_count))
+					.Value(static_cast<int>(item.span_count))
 					.Key("time"s)
-					.Value(edge.weight)
+					.Value(item.time)
 				.EndDict()
 				.Build()
 			);
 		}
 	}
 
-	return json::Builder{}
-		.StartDict()
-			.Key("request_id"s)
-			.Value(request_map.at("id"s))
-			.Key("total_time"s)
-			.Value(result.value().time)
-			.Key("items"s)
-			.Value(items_array)
-		.EndDict()
-		.Build();
+	return items_array;
 }
 
 /**
@@ -502,10 +884,145 @@ void JsonIOHandler::ProcessRouteSettings(const json::Node& settings) {
 		throw invalid_argument("Missing visualisation settings"s);
 	}
 
-	router_.SetRouteSettings({
+	RouteSettings route_settings{
 		settings.AsDict().at("bus_wait_time"s).AsInt(),
 		settings.AsDict().at("bus_velocity"s).AsInt()
-	});
+	};
+
+	router_.SetRouteSettings(FillRouteSettings(settings, move(route_settings)));
+}
+/**
+ * Обрабатывает узел настроек маршрутизации в запросе process_requests:
+ * пересчитывает веса орграфа базы по измененным настройкам
+*/
+void JsonIOHandler::ProcessRouteCustomization(const json::Node& settings) {
+	// Если настройки находятся не в словаре - выбрасываем исключение invalid_argument
+	if (!settings.IsDict()) {
+		throw invalid_argument("Routing settings node must be map"s);
+	}
+
+	router_.Customize(FillRouteSettings(settings, router_.GetRouteSettings()));
+}
+/**
+ * Возвращает настройки route_settings, измененные заданными в узле settings параметрами
+*/
+[[nodiscard]] RouteSettings JsonIOHandler::FillRouteSettings(const json::Node& settings,
+	RouteSettings route_settings) const {
+	// Время ожидания и скорость автобуса
+	auto it = settings.AsDict().find("bus_wait_time"s);
+	if (it != settings.AsDict().end()) {
+		route_settings.wait_time = it->second.AsInt();
+	}
+	it = settings.AsDict().find("bus_velocity"s);
+	if (it != settings.AsDict().end()) {
+		route_settings.velocity = it->second.AsInt();
+	}
+	// Размер кэша построенных маршрутов задается опционально
+	it = settings.AsDict().find("route_cache_size"s);
+	if (it != settings.AsDict().end()) {
+		if (it->second.AsInt() < 0) {
+			throw invalid_argument("Route cache size must be non-negative"s);
+		}
+		route_settings.route_cache_size = static_cast<size_t>(it->second.AsInt());
+	}
+	// Тип движка маршрутизации задается опционально
+	it = settings.AsDict().find("router_type"s);
+	if (it != settings.AsDict().end()) {
+		route_settings.router_type = GetRouterType(it->second);
+	}
+	// Модель орграфа маршрутов задается опционально
+	it = settings.AsDict().find("graph_model"s);
+	if (it != settings.AsDict().end()) {
+		route_settings.graph_model = GetGraphModel(it->second);
+	}
+	// Число потоков предварительного расчета маршрутов задается опционально
+	it = settings.AsDict().find("precompute_threads"s);
+	if (it != settings.AsDict().end()) {
+		if (it->second.AsInt() < 1) {
+			throw invalid_argument("Precompute threads count must be positive"s);
+		}
+		route_settings.precompute_threads = static_cast<size_t>(it->second.AsInt());
+	}
+	// Число ориентиров движка ALT задается опционально
+	it = settings.AsDict().find("landmark_count"s);
+	if (it != settings.AsDict().end()) {
+		if (it->second.AsInt() < 1) {
+			throw invalid_argument("Landmark count must be positive"s);
+		}
+		route_settings.landmark_count = static_cast<size_t>(it->second.AsInt());
+	}
+	// Индекс хабов для запросов времени маршрута строится опционально
+	it = settings.AsDict().find("hub_labels"s);
+	if (it != settings.AsDict().end()) {
+		route_settings.hub_labels = it->second.AsBool();
+	}
+	// Целочисленные веса ребер задаются опционально
+	it = settings.AsDict().find("integer_weights"s);
+	if (it != settings.AsDict().end()) {
+		route_settings.integer_weights = it->second.AsBool();
+	}
+	// Остальные движки ищут по весам с плавающей точкой - округление лишь изменило бы их ответы
+	if (route_settings.integer_weights && route_settings.router_type != RouterType::DIJKSTRA) {
+		throw invalid_argument("Integer weights are supported only by the dijkstra router"s);
+	}
+
+	return route_settings;
+}
+/**
+ * Возвращает тип движка маршрутизации, указанный в переданном узле
+*/
+[[nodiscard]] RouterType JsonIOHandler::GetRouterType(const json::Node& type_node) const {
+	// Если узел не является строкой - выбрасываем исключение
+	if (!type_node.IsString()) {
+		throw invalid_argument("Router type must be string"s);
+	}
+
+	if (type_node.AsString() == "all_pairs"s) {
+		return RouterType::ALL_PAIRS;
+	}
+	else if (type_node.AsString() == "dijkstra"s) {
+		return RouterType::DIJKSTRA;
+	}
+	else if (type_node.AsString() == "contraction_hierarchy"s) {
+		return RouterType::CONTRACTION_HIERARCHY;
+	}
+	else if (type_node.AsString() == "a_star"s) {
+		return RouterType::A_STAR;
+	}
+	else if (type_node.AsString() == "bidirectional_dijkstra"s) {
+		return RouterType::BIDIRECTIONAL_DIJKSTRA;
+	}
+	else if (type_node.AsString() == "alt"s) {
+		return RouterType::ALT;
+	}
+	else if (type_node.AsString() == "compact_all_pairs"s) {
+		return RouterType::COMPACT_ALL_PAIRS;
+	}
+	else if (type_node.AsString() == "multilevel_dijkstra"s) {
+		return RouterType::MULTILEVEL_DIJKSTRA;
+	}
+	else {
+		throw invalid_argument("Unknown router type"s);
+	}
+}
+/**
+ * Возвращает модель орграфа маршрутов, указанную в переданном узле
+*/
+[[nodiscard]] GraphModel JsonIOHandler::GetGraphModel(const json::Node& model_node) const {
+	// Если узел не является строкой - выбрасываем исключение
+	if (!model_node.IsString()) {
+		throw invalid_argument("Graph model must be string"s);
+	}
+
+	if (model_node.AsString() == "complete"s) {
+		return GraphModel::COMPLETE;
+	}
+	else if (model_node.AsString() == "linear"s) {
+		return GraphModel::LINEAR;
+	}
+	else {
+		throw invalid_argument("Unknown graph model"s);
+	}
 }
 
 /**
@@ -525,5 +1042,23 @@ void JsonIOHandler::ProcessSerializationSettings(const json::Node& settings) {
 		settings.AsDict().at("file"s).AsString(),
 	});
 }
+/**
+ * Обрабатывает узел настроек обработки поисковых запросов
+*/
+void JsonIOHandler::ProcessStatSettings(const json::Node& settings) {
+	// Если настройки находятся не в словаре - выбрасываем исключение invalid_argument
+	if (!settings.IsDict()) {
+		throw invalid_argument("Stat settings node must be map"s);
+	}
+
+	// Число потоков обработки задается опционально
+	const auto it = settings.AsDict().find("threads"s);
+	if (it != settings.AsDict().end()) {
+		if (it->second.AsInt() <= 0) {
+			throw invalid_argument("Stat threads count must be positive"s);
+		}
+		stat_threads_ = static_cast<size_t>(it->second.AsInt());
+	}
+}
 
 } // namespace transport_catalogue
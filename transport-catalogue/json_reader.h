@@ -25,6 +25,7 @@ public:
 
 	void ProcessSerializationSettingsRequest();
 	void ProcessMakeBaseRequests();
+	void ProcessUpdateBaseRequests();
 	[[nodiscard]] json::Document ProcessStatsRequests();
 
 private:
@@ -40,6 +41,7 @@ private:
 	std::istream& input_stream_; // Поток ввода запросов
 
 	std::optional<json::Document> requests_ = std::nullopt; // Документ запросов
+	size_t stat_threads_ = 1; // Число потоков обработки поисковых запросов
 
 	void ProcessInsertationRequests(const json::Node& requests);
 
@@ -47,18 +49,28 @@ private:
 	void AddStop(const json::Dict& request_map);
 
 	[[nodiscard]] json::Document ProcessStatRequests(const json::Node& requests) const;
+	[[nodiscard]] std::optional<json::Node> ProcessStatRequest(const json::Node& request_map) const;
 
 	[[nodiscard]] json::Node FindStop(const json::Dict& request_map) const;
 	[[nodiscard]] json::Node FindRoute(const json::Dict& request_map) const;
 	[[nodiscard]] json::Node RenderMap(const json::Dict& request_map) const;
 	[[nodiscard]] json::Node BuildRoute(const json::Dict& request_map) const;
+	[[nodiscard]] json::Node BuildRouteMatrix(const json::Dict& request_map) const;
+	[[nodiscard]] json::Node BuildJourney(const json::Dict& request_map) const;
+	[[nodiscard]] json::Node BuildIsochrone(const json::Dict& request_map) const;
+	[[nodiscard]] json::Array GetRouteItems(const std::vector<RouteItem>& items) const;
 
 	void ProcessVisualisationSettings(const json::Node& settings);
 	[[nodiscard]] svg::Color GetColor(const json::Node& color_node) const;
 
 	void ProcessRouteSettings(const json::Node& settings);
+	void ProcessRouteCustomization(const json::Node& settings);
+	[[nodiscard]] RouteSettings FillRouteSettings(const json::Node& settings, RouteSettings route_settings) const;
+	[[nodiscard]] RouterType GetRouterType(const json::Node& type_node) const;
+	[[nodiscard]] GraphModel GetGraphModel(const json::Node& model_node) const;
 
 	void ProcessSerializationSettings(const json::Node& settings);
+	void ProcessStatSettings(const json::Node& settings);
 };
 
 } // namespace transport_catalogue
@@ -0,0 +1,244 @@
+#pragma once
+
+#include "dijkstra_router.h"
+#include "graph.h"
+#include "router.h"
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+/**
+ * Маршрутизатор ALT (A*, Landmarks, Triangle inequality). При создании выбираются
+ * вершины-ориентиры и рассчитываются веса кратчайших путей от каждого ориентира до всех
+ * вершин и от всех вершин до каждого ориентира. Запрос - поиск A*, нижняя оценка веса
+ * пути до цели получается из этих весов по неравенству треугольника.
+ * Требует построенных у графа списков входящих ребер
+*/
+template <typename Weight>
+class LandmarkRouter {
+private:
+    using Graph = DirectedWeightedGraph<Weight>;
+
+public:
+    using RouteInfo = typename Router<Weight>::RouteInfo;
+    using SearchStats = typename DijkstraRouter<Weight>::SearchStats;
+
+    /**
+     * Ориентиры и веса путей, достаточные для создания маршрутизатора без повторного расчета.
+     * Веса хранятся по вершинам: вес для вершины v и ориентира k - [v * landmarks.size() + k],
+     * недостижимым вершинам соответствует INFINITE_WEIGHT
+    */
+    struct LandmarkData {
+        std::vector<VertexId> landmarks;
+        std::vector<Weight> from_landmarks; // Вес пути от ориентира до вершины
+        std::vector<Weight> to_landmarks; // Вес пути от вершины до ориентира
+    };
+
+    static constexpr Weight INFINITE_WEIGHT = std::numeric_limits<Weight>::max();
+
+    LandmarkRouter(const Graph& graph, size_t landmark_count);
+    LandmarkRouter(const Graph& graph, LandmarkData landmark_data);
+
+    std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to, SearchStats* stats = nullptr) const;
+    const LandmarkData& GetLandmarkData() const;
+
+private:
+    using QueueItem = std::pair<Weight, VertexId>;
+    using Queue = std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>>;
+
+    static constexpr Weight ZERO_WEIGHT{};
+
+    const Graph& graph_;
+    DijkstraRouter<Weight> dijkstra_router_;
+    LandmarkData landmark_data_;
+
+    void SelectLandmarks(size_t landmark_count);
+    std::vector<Weight> ComputeWeights(VertexId from, bool is_forward) const;
+    Weight GetLowerBound(VertexId vertex, VertexId to) const;
+};
+
+template <typename Weight>
+LandmarkRouter<Weight>::LandmarkRouter(const Graph& graph, size_t landmark_count)
+    : graph_(graph)
+    , dijkstra_router_(graph)
+{
+    if (!graph_.HasReverseIncidence()) {
+        throw std::invalid_argument("Graph should have reverse incidence lists");
+    }
+    SelectLandmarks(landmark_count);
+}
+
+template <typename Weight>
+LandmarkRouter<Weight>::LandmarkRouter(const Graph& graph, LandmarkData landmark_data)
+    : graph_(graph)
+    , dijkstra_router_(graph)
+    , landmark_data_(std::move(landmark_data))
+{
+    const size_t vertex_count = graph_.GetVertexCount();
+    const size_t weights_count = vertex_count * landmark_data_.landmarks.size();
+    if (landmark_data_.from_landmarks.size() != weights_count
+        || landmark_data_.to_landmarks.size() != weights_count) {
+        throw std::invalid_argument("Landmarks' weights count doesn't match the graph");
+    }
+    for (const VertexId landmark : landmark_data_.landmarks) {
+        if (landmark >= vertex_count) {
+            throw std::invalid_argument("Landmark doesn't match the graph");
+        }
+    }
+}
+
+/**
+ * Строит маршрут поиском A*. Для каждого ориентира L вес пути от v до to не меньше
+ * d(L, to) - d(L, v) и d(v, L) - d(to, L), потенциал вершины - наибольшая из этих оценок
+*/
+template <typename Weight>
+std::optional<typename LandmarkRouter<Weight>::RouteInfo> LandmarkRouter<Weight>::BuildRoute(
+    VertexId from, VertexId to, SearchStats* stats) const {
+    return dijkstra_router_.BuildRouteWithPotential(from, to,
+        [this, to](VertexId vertex) { return GetLowerBound(vertex, to); }, stats);
+}
+
+template <typename Weight>
+const typename LandmarkRouter<Weight>::LandmarkData& LandmarkRouter<Weight>::GetLandmarkData() const {
+    return landmark_data_;
+}
+
+/**
+ * Выбирает до landmark_count ориентиров "дальней точкой": очередной ориентир - вершина,
+ * наиболее удаленная от уже выбранных по сумме весов путей туда и обратно.
+ * Первый ориентир - вершина, наиболее удаленная от вершины с наибольшим числом исходящих ребер.
+ * Учитываются только вершины, связанные с ориентирами в обе стороны, поэтому
+ * остановки без маршрутов ориентирами не становятся
+*/
+template <typename Weight>
+void LandmarkRouter<Weight>::SelectLandmarks(size_t landmark_count) {
+    const size_t vertex_count = graph_.GetVertexCount();
+    if (landmark_count == 0 || graph_.GetEdgeCount() == 0) {
+        return;
+    }
+
+    // Наименьшая сумма весов путей до выбранных ориентиров и обратно
+    std::vector<Weight> distances(vertex_count, INFINITE_WEIGHT);
+    const auto update_distances = [&distances](const std::vector<Weight>& from_weights,
+        const std::vector<Weight>& to_weights) {
+        for (size_t vertex = 0; vertex < distances.size(); ++vertex) {
+            if (from_weights[vertex] != INFINITE_WEIGHT && to_weights[vertex] != INFINITE_WEIGHT) {
+                distances[vertex] = std::min(distances[vertex], from_weights[vertex] + to_weights[vertex]);
+            }
+        }
+    };
+
+    VertexId start = 0;
+    size_t start_degree = 0;
+    for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+        const auto edges = graph_.GetIncidentEdges(vertex);
+        const size_t degree = static_cast<size_t>(std::distance(edges.begin(), edges.end()));
+        if (degree > start_degree) {
+            start = vertex;
+            start_degree = degree;
+        }
+    }
+    update_distances(ComputeWeights(start, true), ComputeWeights(start, false));
+
+    std::vector<std::vector<Weight>> from_weights;
+    std::vector<std::vector<Weight>> to_weights;
+    while (landmark_data_.landmarks.size() < landmark_count) {
+        // Вершины, совпадающие с ориентирами, имеют нулевое расстояние и не выбираются
+        std::optional<VertexId> farthest;
+        for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+            if (distances[vertex] != INFINITE_WEIGHT && distances[vertex] > ZERO_WEIGHT
+                && (!farthest || distances[vertex] > distances[*farthest])) {
+                farthest = vertex;
+            }
+        }
+        if (!farthest) {
+            break;
+        }
+
+        landmark_data_.landmarks.push_back(*farthest);
+        from_weights.push_back(ComputeWeights(*farthest, true));
+        to_weights.push_back(ComputeWeights(*farthest, false));
+        update_distances(from_weights.back(), to_weights.back());
+    }
+
+    // Переставляем веса по вершинам: оценка вершины читает веса всех ориентиров подряд
+    const size_t count = landmark_data_.landmarks.size();
+    landmark_data_.from_landmarks.resize(vertex_count * count);
+    landmark_data_.to_landmarks.resize(vertex_count * count);
+    for (size_t landmark = 0; landmark < count; ++landmark) {
+        for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+            landmark_data_.from_landmarks[vertex * count + landmark] = from_weights[landmark][vertex];
+            landmark_data_.to_landmarks[vertex * count + landmark] = to_weights[landmark][vertex];
+        }
+    }
+}
+
+/**
+ * Возвращает веса кратчайших путей от вершины from до всех вершин (is_forward),
+ * либо от всех вершин до from, INFINITE_WEIGHT - путь не существует
+*/
+template <typename Weight>
+std::vector<Weight> LandmarkRouter<Weight>::ComputeWeights(VertexId from, bool is_forward) const {
+    std::vector<Weight> weights(graph_.GetVertexCount(), INFINITE_WEIGHT);
+    std::vector<bool> settled(graph_.GetVertexCount(), false);
+
+    Queue queue;
+    weights[from] = ZERO_WEIGHT;
+    queue.push({ZERO_WEIGHT, from});
+
+    while (!queue.empty()) {
+        const VertexId vertex = queue.top().second;
+        queue.pop();
+        if (settled[vertex]) {
+            continue;
+        }
+        settled[vertex] = true;
+
+        const auto edges = is_forward ? graph_.GetIncidentEdges(vertex) : graph_.GetIncomingEdges(vertex);
+        for (const EdgeId edge_id : edges) {
+            const auto& edge = graph_.GetEdge(edge_id);
+            const VertexId next = is_forward ? edge.to : edge.from;
+            const Weight candidate_weight = weights[vertex] + edge.weight;
+            if (candidate_weight < weights[next]) {
+                weights[next] = candidate_weight;
+                queue.push({candidate_weight, next});
+            }
+        }
+    }
+    return weights;
+}
+
+/**
+ * Возвращает нижнюю оценку веса пути от vertex до to. Оценки по ориентирам,
+ * недостижимым из вершин или недостигающим их, не учитываются
+*/
+template <typename Weight>
+Weight LandmarkRouter<Weight>::GetLowerBound(VertexId vertex, VertexId to) const {
+    const size_t count = landmark_data_.landmarks.size();
+    const Weight* vertex_from = landmark_data_.from_landmarks.data() + vertex * count;
+    const Weight* vertex_to = landmark_data_.to_landmarks.data() + vertex * count;
+    const Weight* target_from = landmark_data_.from_landmarks.data() + to * count;
+    const Weight* target_to = landmark_data_.to_landmarks.data() + to * count;
+
+    Weight bound = ZERO_WEIGHT;
+    for (size_t landmark = 0; landmark < count; ++landmark) {
+        if (vertex_from[landmark] != INFINITE_WEIGHT && target_from[landmark] != INFINITE_WEIGHT) {
+            bound = std::max(bound, target_from[landmark] - vertex_from[landmark]);
+        }
+        if (vertex_to[landmark] != INFINITE_WEIGHT && target_to[landmark] != INFINITE_WEIGHT) {
+            bound = std::max(bound, vertex_to[landmark] - target_to[landmark]);
+        }
+    }
+    return bound;
+}
+
+}  // namespace graph
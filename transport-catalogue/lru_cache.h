@@ -0,0 +1,131 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+
+namespace transport_catalogue {
+
+/**
+ * Ограниченный по размеру кэш, вытесняющий давнее всего использованные элементы.
+ * Все методы можно вызывать конкурентно: доступ к содержимому защищен мьютексом,
+ * счетчики попаданий и промахов атомарны. Кэш нулевой емкости ничего не хранит
+*/
+template <typename Key, typename Value, typename Hasher = std::hash<Key>>
+class LruCache {
+public:
+    explicit LruCache(size_t capacity = 0)
+        : capacity_(capacity) {}
+
+    std::optional<Value> Get(const Key& key);
+    void Put(const Key& key, Value value);
+
+    void SetCapacity(size_t capacity);
+    void Clear();
+
+    size_t GetCapacity() const;
+    size_t GetSize() const;
+    size_t GetHits() const;
+    size_t GetMisses() const;
+
+private:
+    // Элементы в порядке использования: в начале - использованные последними
+    using Items = std::list<std::pair<Key, Value>>;
+
+    mutable std::mutex mutex_;
+    size_t capacity_;
+    Items items_;
+    std::unordered_map<Key, typename Items::iterator, Hasher> positions_;
+
+    std::atomic<size_t> hits_{0};
+    std::atomic<size_t> misses_{0};
+};
+
+/**
+ * Возвращает значение по ключу и отмечает его как использованное последним,
+ * либо nullopt, если ключа в кэше нет
+*/
+template <typename Key, typename Value, typename Hasher>
+std::optional<Value> LruCache<Key, Value, Hasher>::Get(const Key& key) {
+    std::lock_guard guard(mutex_);
+
+    const auto it = positions_.find(key);
+    if (it == positions_.end()) {
+        ++misses_;
+        return std::nullopt;
+    }
+    ++hits_;
+    items_.splice(items_.begin(), items_, it->second);
+    return it->second->second;
+}
+/**
+ * Записывает значение по ключу, при переполнении вытесняет давнее всего использованный элемент
+*/
+template <typename Key, typename Value, typename Hasher>
+void LruCache<Key, Value, Hasher>::Put(const Key& key, Value value) {
+    std::lock_guard guard(mutex_);
+    if (capacity_ == 0) {
+        return;
+    }
+
+    const auto it = positions_.find(key);
+    if (it != positions_.end()) {
+        it->second->second = std::move(value);
+        items_.splice(items_.begin(), items_, it->second);
+        return;
+    }
+
+    if (items_.size() == capacity_) {
+        positions_.erase(items_.back().first);
+        items_.pop_back();
+    }
+    items_.emplace_front(key, std::move(value));
+    positions_[key] = items_.begin();
+}
+
+/**
+ * Задает емкость кэша, содержимое и счетчики сбрасываются
+*/
+template <typename Key, typename Value, typename Hasher>
+void LruCache<Key, Value, Hasher>::SetCapacity(size_t capacity) {
+    std::lock_guard guard(mutex_);
+    capacity_ = capacity;
+    items_.clear();
+    positions_.clear();
+    hits_ = 0;
+    misses_ = 0;
+}
+/**
+ * Удаляет все элементы кэша, счетчики сохраняются
+*/
+template <typename Key, typename Value, typename Hasher>
+void LruCache<Key, Value, Hasher>::Clear() {
+    std::lock_guard guard(mutex_);
+    items_.clear();
+    positions_.clear();
+}
+
+template <typename Key, typename Value, typename Hasher>
+size_t LruCache<Key, Value, Hasher>::GetCapacity() const {
+    std::lock_guard guard(mutex_);
+    return capacity_;
+}
+template <typename Key, typename Value, typename Hasher>
+size_t LruCache<Key, Value, Hasher>::GetSize() const {
+    std::lock_guard guard(mutex_);
+    return items_.size();
+}
+template <typename Key, typename Value, typename Hasher>
+size_t LruCache<Key, Value, Hasher>::GetHits() const {
+    return hits_;
+}
+template <typename Key, typename Value, typename Hasher>
+size_t LruCache<Key, Value, Hasher>::GetMisses() const {
+    return misses_;
+}
+
+} // namespace transport_catalogue
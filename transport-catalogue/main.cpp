@@ -7,23 +7,33 @@
 using namespace std::literals;
 
 void PrintUsage(std::ostream& stream = std::cerr) {
-    stream << "Usage: transport_catalogue [make_base|process_requests]\n"sv;
+    stream << "Usage: transport_catalogue [make_base [--update]|process_requests]\n"sv;
 }
 
 int main(int argc, char* argv[]) {
-    if (argc != 2) {
+    if (argc != 2 && argc != 3) {
         PrintUsage();
         return 1;
     }
 
     const std::string_view mode(argv[1]);
+    // Флаг --update допустим только для make_base
+    const bool is_update = argc == 3;
+    if (is_update && (mode != "make_base"sv || std::string_view(argv[2]) != "--update"sv)) {
+        PrintUsage();
+        return 1;
+    }
 
     // Объявляем транспортный справочник
     transport_catalogue::TransportCatalogue catalogue;
     // Объявляем обработчик запросов
     transport_catalogue::Handler handler(catalogue);
 
-    if (mode == "make_base"sv) {
+    if (mode == "make_base"sv && is_update) {
+        // Добавляем маршруты в существующую базу
+        handler.UpdateSerializedData();
+    }
+    else if (mode == "make_base"sv) {
         // Выполняем сериализацию данных
         handler.SerializeData();
     }
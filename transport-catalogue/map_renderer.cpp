@@ -21,7 +21,7 @@ void MapRenderer::SetRenderSettings(MapVisualisationSettings settings) {
 }
 
 // Рендер карты транспортного справочника
-void MapRenderer::Rend(ostream& os) {
+void MapRenderer::Rend(ostream& os) const {
     // Создадим множество координат остановок
     set<geo::Coordinates> stops_corrdinates;
     
@@ -37,12 +37,14 @@ void MapRenderer::Rend(ostream& os) {
     const SphereProjector projector{ stops_corrdinates.begin(), stops_corrdinates.end(),
             settings_.width, settings_.height, settings_.padding };
         
+    // Слои карты локальны для вызова, поэтому рендер не меняет состояние объекта
+    MapLayers layers;
     // Добавляем линии и названия маршрутов
-    RenderRoutes(projector);
+    RenderRoutes(layers, projector);
     // Добавляем отметки остановок
-    RenderStops(projector);
+    RenderStops(layers, projector);
 
-    Print(os);
+    Print(layers, os);
 }
 
 // Возвращает константную ссылку на настройки визуализации
@@ -51,20 +53,20 @@ const MapVisualisationSettings& MapRenderer::GetSettings() const {
 }
 
 // Выводит итоговый svg-документа в указанный поток
-void MapRenderer::Print(std::ostream& os) {
+void MapRenderer::Print(const MapLayers& layers, std::ostream& os) const {
     svg::Document data; // Итоговый svg-документ
 
     // Добавляем все имеющиеся данные для рендера в итоговый svg-документ
-    for (const auto& route_polyline : routes_polylines_) {
+    for (const auto& route_polyline : layers.routes_polylines) {
         data.Add(route_polyline);
     }
-    for (const auto& routes_name : routes_names_) {
+    for (const auto& routes_name : layers.routes_names) {
         data.Add(routes_name);
     }
-    for (const auto& stops_circle : stops_circles_) {
+    for (const auto& stops_circle : layers.stops_circles) {
         data.Add(stops_circle);
     }
-    for (const auto& stops_name : stops_names_) {
+    for (const auto& stops_name : layers.stops_names) {
         data.Add(stops_name);
     }
 
@@ -96,7 +98,7 @@ std::vector<svg::Point> MapRenderer::ConvertToPixels(const set<geo::Coordinates>
 }
 
 // Рендер маршрутов
-void MapRenderer::RenderRoutes(const SphereProjector& projector) {
+void MapRenderer::RenderRoutes(MapLayers& layers, const SphereProjector& projector) const {
     // Создаем сортированный словарь маршрутов
     map<string_view, transport_catalogue::domain::Route*> sorted_routes;
     for (const auto& [route_name, route_info] : catalogue_.GetRoutesMap()) {
@@ -112,7 +114,7 @@ void MapRenderer::RenderRoutes(const SphereProjector& projector) {
 
         vector<svg::Point> stops = ConvertToPixels(route_info->stops, projector);
         // Добавляем полилинию маршрута в вектор полилиний
-        AddRoutesPolylines(stops);
+        AddRoutesPolylines(layers, stops);
 
         vector<svg::Point> stops_screen_coordinates; // Вектор экранных координат маршрута
 
@@ -122,24 +124,24 @@ void MapRenderer::RenderRoutes(const SphereProjector& projector) {
         }
 
         // Добавляем название маршрута
-        AddRouteName(route_name, stops_screen_coordinates.front());
+        AddRouteName(layers, route_name, stops_screen_coordinates.front());
         // Если маршрут не круговой - добавляем наименование маршрута на финальную остановку
         if (!route_info->is_round) {
             if (FindSecondEndingStation(stops_screen_coordinates)) {
-                AddRouteName(route_name, FindSecondEndingStation(stops_screen_coordinates).value());
+                AddRouteName(layers, route_name, FindSecondEndingStation(stops_screen_coordinates).value());
             }
         }
 
         // Обновляем счетчик палитры
-        ++current_palit_pos_;
+        ++layers.current_palit_pos;
         // Если счетчик палтиры стал >= размеру палитры, обнуляем счетчик
-        if (current_palit_pos_ >= settings_.color_palette.size()) {
-            current_palit_pos_ = 0;
+        if (layers.current_palit_pos >= settings_.color_palette.size()) {
+            layers.current_palit_pos = 0;
         }
     }
 }
 // Рендер остановок
-void MapRenderer::RenderStops(const SphereProjector& projector) {
+void MapRenderer::RenderStops(MapLayers& layers, const SphereProjector& projector) const {
     // Создаем сортированный словарь маршрутов
     std::map<std::string_view, transport_catalogue::domain::Stop*> sorted_stops;
     for (const auto& [stop_name, stop_info] : catalogue_.GetStopsMap()) {
@@ -157,15 +159,15 @@ void MapRenderer::RenderStops(const SphereProjector& projector) {
         circle.SetCenter(projector({ stop_info->latitude, stop_info->longitude }))
             .SetRadius(settings_.stop_radius)
             .SetFillColor("white"s);
-        stops_circles_.push_back(circle);
+        layers.stops_circles.push_back(circle);
 
         // Добавляем наименовние остановки
-        AddStopName(projector({ stop_info->latitude, stop_info->longitude }), stop_name);
+        AddStopName(layers, projector({ stop_info->latitude, stop_info->longitude }), stop_name);
     }
 }
 
 // Добавляет наименования автобусных остановок 
-void MapRenderer::AddStopName(const svg::Point& pos, string_view stop_name) {
+void MapRenderer::AddStopName(MapLayers& layers, const svg::Point& pos, string_view stop_name) const {
     svg::Text name; // Наименование маршрута
 
     name.SetPosition(pos)
@@ -184,11 +186,11 @@ void MapRenderer::AddStopName(const svg::Point& pos, string_view stop_name) {
 
     name.SetFillColor("black"s);
 
-    stops_names_.push_back(underlayer);
-    stops_names_.push_back(name);
+    layers.stops_names.push_back(underlayer);
+    layers.stops_names.push_back(name);
 }
-// Добавляет полилинии маршрутов в routes_polylines_
-void MapRenderer::AddRoutesPolylines(const vector<svg::Point>& coordinates) {
+// Добавляет полилинии маршрутов в routes_polylines
+void MapRenderer::AddRoutesPolylines(MapLayers& layers, const vector<svg::Point>& coordinates) const {
     svg::Polyline polyline; // Полилиния маршрута
 
     // Добавляем точки в полилинию маршрута
@@ -197,16 +199,16 @@ void MapRenderer::AddRoutesPolylines(const vector<svg::Point>& coordinates) {
     }
 
     // Добавляем получившуюся полилинию в вектор полилиний маршрутов
-    routes_polylines_.push_back(
+    layers.routes_polylines.push_back(
         polyline.SetFillColor(svg::NoneColor)
-        .SetStrokeColor(settings_.color_palette.at(current_palit_pos_))
+        .SetStrokeColor(settings_.color_palette.at(layers.current_palit_pos))
         .SetStrokeWidth(settings_.line_width)
         .SetStrokeLineCap(svg::StrokeLineCap::ROUND)
         .SetStrokeLineJoin(svg::StrokeLineJoin::ROUND)
     );
 }
-// Добавляет наименования маршрутов с подложками в routes_names_
-void MapRenderer::AddRouteName(string_view route_name, svg::Point pos) {
+// Добавляет наименования маршрутов с подложками в routes_names
+void MapRenderer::AddRouteName(MapLayers& layers, string_view route_name, svg::Point pos) const {
     svg::Text name; // Наименование маршрута
 
     name.SetPosition(pos)
@@ -224,10 +226,10 @@ void MapRenderer::AddRouteName(string_view route_name, svg::Point pos) {
         .SetStrokeLineCap(svg::StrokeLineCap::ROUND)
         .SetStrokeLineJoin(svg::StrokeLineJoin::ROUND);
 
-    name.SetFillColor(settings_.color_palette.at(current_palit_pos_));
+    name.SetFillColor(settings_.color_palette.at(layers.current_palit_pos));
 
-    routes_names_.push_back(underlayer);
-    routes_names_.push_back(name);
+    layers.routes_names.push_back(underlayer);
+    layers.routes_names.push_back(name);
 }
 
 // Возвращает положение второй конечной остановки для некольцевых маршрутов
@@ -50,8 +50,8 @@ public:
     // Задает настройки визуализации
     void SetRenderSettings(MapVisualisationSettings settings);
 
-    // Рендер карты транспортного справочника
-    void Rend(std::ostream& os);
+    // Рендер карты транспортного справочника, можно вызывать конкурентно
+    void Rend(std::ostream& os) const;
 
     // Возвращает константную ссылку на настройки визуализации
     const MapVisualisationSettings& GetSettings() const;
@@ -60,15 +60,18 @@ private:
     MapVisualisationSettings settings_; // Настройки визуализации
     const transport_catalogue::TransportCatalogue& catalogue_; // Ссылка на базу данных
 
-    size_t current_palit_pos_ = 0; // Счетчик позиции в массиве палитры
+    // Слои карты, заполняемые в ходе одного рендера
+    struct MapLayers {
+        size_t current_palit_pos = 0; // Счетчик позиции в массиве палитры
 
-    std::vector<svg::Polyline> routes_polylines_; // Вектор полилиний маршрутов
-    std::vector<svg::Text> routes_names_; // Вектор наименований маршрутов
-    std::vector<svg::Circle> stops_circles_; // Вектор обозначений остановок
-    std::vector<svg::Text> stops_names_; // Вектор наименование остановок
+        std::vector<svg::Polyline> routes_polylines; // Вектор полилиний маршрутов
+        std::vector<svg::Text> routes_names; // Вектор наименований маршрутов
+        std::vector<svg::Circle> stops_circles; // Вектор обозначений остановок
+        std::vector<svg::Text> stops_names; // Вектор наименование остановок
+    };
 
     // Выводит итоговый svg-документа в указанный поток
-    void Print(std::ostream& os);
+    void Print(const MapLayers& layers, std::ostream& os) const;
 
     // Конвертирует вектор остановок в вектор пикселей
     std::vector<svg::Point> ConvertToPixels(const std::vector<transport_catalogue::domain::Stop*>& stops,
@@ -78,16 +81,16 @@ private:
         const SphereProjector& projector) const;
 
     // Рендер маршрутов
-    void RenderRoutes(const SphereProjector& projector);
+    void RenderRoutes(MapLayers& layers, const SphereProjector& projector) const;
     // Рендер остановок
-    void RenderStops(const SphereProjector& projector);
+    void RenderStops(MapLayers& layers, const SphereProjector& projector) const;
 
     // Добавляет наименования автобусных остановок 
-    void AddStopName(const svg::Point& position, std::string_view name);
-    // Добавляет полилинии маршрутов в routes_polylines_
-    void AddRoutesPolylines(const std::vector<svg::Point>& coordinates);
-    // Добавляет наименование маршрута с подложкой в routes_names_
-    void AddRouteName(std::string_view route_name, svg::Point pos);
+    void AddStopName(MapLayers& layers, const svg::Point& position, std::string_view name) const;
+    // Добавляет полилинии маршрутов в routes_polylines
+    void AddRoutesPolylines(MapLayers& layers, const std::vector<svg::Point>& coordinates) const;
+    // Добавляет наименование маршрута с подложкой в routes_names
+    void AddRouteName(MapLayers& layers, std::string_view route_name, svg::Point pos) const;
 
     // Возвращает положение второй конечной остановки для некольцевых маршрутов
     std::optional<svg::Point> FindSecondEndingStation(const std::vector<svg::Point>& route) const;
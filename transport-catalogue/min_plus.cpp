@@ -0,0 +1,87 @@
+#include "min_plus.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define GRAPH_MIN_PLUS_AVX2
+#include <immintrin.h>
+#endif
+
+namespace graph {
+namespace detail {
+
+void RelaxRowMinPlusScalar(float* __restrict weights, uint32_t* __restrict prev_edges,
+                           const float* __restrict weights_through,
+                           const uint32_t* __restrict prev_edges_through,
+                           float weight_from, size_t count) {
+    for (size_t pos = 0; pos < count; ++pos) {
+        const float candidate_weight = weight_from + weights_through[pos];
+        if (candidate_weight < weights[pos]) {
+            weights[pos] = candidate_weight;
+            prev_edges[pos] = prev_edges_through[pos];
+        }
+    }
+}
+
+namespace {
+
+#ifdef GRAPH_MIN_PLUS_AVX2
+/**
+ * Вариант релаксации на AVX2: по восемь ячеек за итерацию. Веса и ребра одной ячейки
+ * одинаковой ширины, поэтому ребра выбираются той же маской сравнения
+*/
+__attribute__((target("avx2")))
+void RelaxRowMinPlusAvx2(float* __restrict weights, uint32_t* __restrict prev_edges,
+                         const float* __restrict weights_through,
+                         const uint32_t* __restrict prev_edges_through,
+                         float weight_from, size_t count) {
+    const __m256 from = _mm256_set1_ps(weight_from);
+
+    size_t pos = 0;
+    for (; pos + 8 <= count; pos += 8) {
+        const __m256 current = _mm256_loadu_ps(weights + pos);
+        const __m256 candidate = _mm256_add_ps(from, _mm256_loadu_ps(weights_through + pos));
+        const __m256 is_shorter = _mm256_cmp_ps(candidate, current, _CMP_LT_OQ);
+        // Чаще всего ни одна ячейка не улучшается - обходимся без записи
+        if (_mm256_movemask_ps(is_shorter) == 0) {
+            continue;
+        }
+        _mm256_storeu_ps(weights + pos, _mm256_blendv_ps(current, candidate, is_shorter));
+
+        const __m256i prev_current = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(prev_edges + pos));
+        const __m256i prev_through = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(prev_edges_through + pos));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(prev_edges + pos),
+                            _mm256_blendv_epi8(prev_current, prev_through, _mm256_castps_si256(is_shorter)));
+    }
+
+    RelaxRowMinPlusScalar(weights + pos, prev_edges + pos, weights_through + pos,
+                          prev_edges_through + pos, weight_from, count - pos);
+}
+#endif
+
+using RelaxRowFunction = void (*)(float*, uint32_t*, const float*, const uint32_t*, float, size_t);
+
+/**
+ * Выбирает вариант релаксации по возможностям процессора
+*/
+RelaxRowFunction SelectRelaxRow() {
+#ifdef GRAPH_MIN_PLUS_AVX2
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return RelaxRowMinPlusAvx2;
+    }
+#endif
+    return RelaxRowMinPlusScalar;
+}
+
+const RelaxRowFunction relax_row = SelectRelaxRow();
+
+}  // namespace
+
+void RelaxRowMinPlus(float* weights, uint32_t* prev_edges,
+                     const float* weights_through, const uint32_t* prev_edges_through,
+                     float weight_from, size_t count) {
+    relax_row(weights, prev_edges, weights_through, prev_edges_through, weight_from, count);
+}
+
+}  // namespace detail
+}  // namespace graph
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace graph {
+namespace detail {
+
+/**
+ * Релаксация отрезка строки таблицы маршрутов через вершину (min-plus):
+ * weights[i] = min(weights[i], weight_from + weights_through[i]), при улучшении
+ * prev_edges[i] = prev_edges_through[i]. Строки не должны пересекаться.
+ * Использует AVX2, если его поддерживает процессор, иначе скалярный цикл;
+ * результат обоих вариантов совпадает побитово
+*/
+void RelaxRowMinPlus(float* weights, uint32_t* prev_edges,
+                     const float* weights_through, const uint32_t* prev_edges_through,
+                     float weight_from, size_t count);
+/**
+ * Скалярный вариант RelaxRowMinPlus, используется без AVX2, для хвоста строки
+ * и для сравнения вариантов в min_plus_bench
+*/
+void RelaxRowMinPlusScalar(float* weights, uint32_t* prev_edges,
+                           const float* weights_through, const uint32_t* prev_edges_through,
+                           float weight_from, size_t count);
+
+}  // namespace detail
+}  // namespace graph
@@ -0,0 +1,133 @@
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "min_plus.h"
+
+/**
+ * Микробенчмарк ядра релаксации таблицы маршрутов all_pairs: скалярный вариант
+ * RelaxRowMinPlusScalar против варианта, выбранного по возможностям процессора.
+ * Строки длиной V вершин релаксируются через строки-посредники, как в алгоритме
+ * Флойда-Уоршелла; таблицы обоих вариантов после прогона сравниваются побитово.
+ * Запуск: min_plus_bench [V ...], по умолчанию V = 1000 4000 8000
+*/
+
+using namespace std::literals;
+
+namespace {
+
+// Число строк таблицы: ограничивает её объем при больших V, длина строки остается V
+constexpr size_t ROWS_COUNT = 512;
+// Число вершин-посредников, через которые релаксируется каждая строка
+constexpr size_t PIVOTS_COUNT = 64;
+
+using RelaxRowFunction = void (*)(float*, uint32_t*, const float*, const uint32_t*, float, size_t);
+
+/**
+ * Строки таблицы маршрутов, плоско и построчно, как в graph::Router
+*/
+struct RowsTable {
+    size_t row_size = 0;
+    std::vector<float> weights;
+    std::vector<uint32_t> prev_edges;
+};
+
+/**
+ * Заполняет таблицу полусошедшимися весами: пятая часть маршрутов отсутствует,
+ * остальные веса случайны, маршрут из вершины в себя имеет нулевой вес
+*/
+RowsTable MakeRowsTable(size_t vertex_count) {
+    std::mt19937 generator(3);
+    std::uniform_real_distribution<float> weight_distribution(0.0f, 100.0f);
+
+    RowsTable table{ vertex_count, std::vector<float>(ROWS_COUNT * vertex_count),
+        std::vector<uint32_t>(ROWS_COUNT * vertex_count) };
+    for (size_t pos = 0; pos < table.weights.size(); ++pos) {
+        table.weights[pos] = generator() % 5 == 0
+            ? std::numeric_limits<float>::infinity()
+            : weight_distribution(generator);
+        table.prev_edges[pos] = static_cast<uint32_t>(generator());
+    }
+    for (size_t row = 0; row < ROWS_COUNT && row < vertex_count; ++row) {
+        table.weights[row * vertex_count + row] = 0.0f;
+        table.prev_edges[row * vertex_count + row] = std::numeric_limits<uint32_t>::max();
+    }
+    return table;
+}
+
+/**
+ * Релаксирует каждую строку таблицы через PIVOTS_COUNT строк-посредников,
+ * возвращает время на одну ячейку, нс
+*/
+double RunKernel(RelaxRowFunction relax_row, RowsTable& table) {
+    const size_t row_size = table.row_size;
+    size_t cells_count = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t pivot = 0; pivot < PIVOTS_COUNT; ++pivot) {
+        const size_t pivot_row = pivot % ROWS_COUNT;
+        for (size_t row = 0; row < ROWS_COUNT; ++row) {
+            const float weight_from = table.weights[row * row_size + pivot];
+            if (row == pivot_row || weight_from == std::numeric_limits<float>::infinity()) {
+                continue;
+            }
+            relax_row(&table.weights[row * row_size], &table.prev_edges[row * row_size],
+                      &table.weights[pivot_row * row_size], &table.prev_edges[pivot_row * row_size],
+                      weight_from, row_size);
+            cells_count += row_size;
+        }
+    }
+    const std::chrono::duration<double, std::nano> duration = std::chrono::steady_clock::now() - start;
+
+    return duration.count() / static_cast<double>(cells_count);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    std::vector<size_t> vertex_counts;
+    for (int arg = 1; arg < argc; ++arg) {
+        vertex_counts.push_back(std::stoul(argv[arg]));
+    }
+    if (vertex_counts.empty()) {
+        vertex_counts = { 1000, 4000, 8000 };
+    }
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+    __builtin_cpu_init();
+    std::cout << "AVX2: "sv << (__builtin_cpu_supports("avx2") ? "yes"sv : "no"sv) << '\n';
+#endif
+
+    bool is_identical = true;
+    std::cout << std::fixed << std::setprecision(2);
+    for (const size_t vertex_count : vertex_counts) {
+        if (vertex_count <= PIVOTS_COUNT) {
+            std::cerr << "V must be greater than "sv << PIVOTS_COUNT << '\n';
+            return 1;
+        }
+        RowsTable scalar_table = MakeRowsTable(vertex_count);
+        RowsTable dispatched_table = scalar_table;
+
+        const double scalar_time = RunKernel(graph::detail::RelaxRowMinPlusScalar, scalar_table);
+        const double dispatched_time = RunKernel(graph::detail::RelaxRowMinPlus, dispatched_table);
+
+        const bool is_row_identical = std::memcmp(scalar_table.weights.data(), dispatched_table.weights.data(),
+            scalar_table.weights.size() * sizeof(float)) == 0
+            && scalar_table.prev_edges == dispatched_table.prev_edges;
+        is_identical = is_identical && is_row_identical;
+
+        std::cout << "V="sv << vertex_count
+            << " scalar "sv << scalar_time << " ns/cell"sv
+            << ", dispatched "sv << dispatched_time << " ns/cell"sv
+            << ", speedup "sv << scalar_time / dispatched_time << 'x'
+            << ", bitwise identical: "sv << (is_row_identical ? "yes"sv : "no"sv) << '\n';
+    }
+
+    return is_identical ? 0 : 1;
+}
@@ -0,0 +1,631 @@
+#pragma once
+
+#include "dijkstra_router.h"
+#include "graph.h"
+#include "router.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <queue>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+/**
+ * Маршрутизатор Customizable Route Planning - многоуровневый поиск Дейкстры по разбиению орграфа.
+ * Вершины разбиваются на вложенные ячейки нескольких уровней, разбиение зависит только
+ * от топологии орграфа. Для каждой ячейки рассчитывается клика - веса кратчайших путей внутри
+ * ячейки от её входных граничных вершин до выходных. Поиск проходит ячейку, не содержащую
+ * начало и конец маршрута, одним ребром клики наибольшего такого уровня.
+ * Пересчет клик по изменившимся весам ребер (Customize) разбиение не меняет
+*/
+template <typename Weight>
+class MultilevelRouter {
+private:
+    using Graph = DirectedWeightedGraph<Weight>;
+
+public:
+    using RouteInfo = typename Router<Weight>::RouteInfo;
+    using SearchStats = typename DijkstraRouter<Weight>::SearchStats;
+
+    /**
+     * Уровень разбиения: номер ячейки каждой вершины и клики ячеек в порядке их номеров.
+     * Клика - матрица весов путей от входных вершин ячейки (строки) до выходных (столбцы),
+     * граничные вершины упорядочены по id. Недостижимым парам соответствует INFINITE_WEIGHT
+    */
+    struct PartitionLevel {
+        std::vector<uint32_t> cells;
+        std::vector<Weight> clique_weights;
+    };
+    /**
+     * Разбиение и клики, достаточные для создания маршрутизатора без повторного расчета.
+     * Уровни - от мелких ячеек к крупным, ячейка уровня целиком входит в ячейку следующего
+    */
+    struct MultilevelData {
+        std::vector<PartitionLevel> levels;
+    };
+
+    static constexpr Weight INFINITE_WEIGHT = std::numeric_limits<Weight>::max();
+
+    explicit MultilevelRouter(const Graph& graph, size_t threads_count = 1);
+    MultilevelRouter(const Graph& graph, MultilevelData multilevel_data);
+
+    void Customize(size_t threads_count = 1);
+    std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to, SearchStats* stats = nullptr) const;
+    const MultilevelData& GetMultilevelData() const;
+
+private:
+    using QueueItem = std::pair<Weight, VertexId>;
+    using Queue = std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>>;
+    // Смежные единицы разбиения с числом ребер между ними
+    using UnitsAdjacency = std::vector<std::vector<std::pair<uint32_t, size_t>>>;
+
+    static constexpr Weight ZERO_WEIGHT{};
+    static constexpr size_t FIRST_LEVEL_CELL_SIZE = 256; // Наибольшее число вершин ячейки первого уровня
+    static constexpr size_t CELL_SIZE_FACTOR = 4; // Во сколько раз ячейка уровня больше ячейки предыдущего
+    static constexpr uint32_t NO_POSITION = std::numeric_limits<uint32_t>::max();
+    static constexpr VertexId NO_VERTEX = std::numeric_limits<VertexId>::max();
+
+    /**
+     * Граничные вершины ячеек уровня: входные - концы ребер, входящих в ячейку извне,
+     * выходные - начала ребер, выходящих из неё. Вершины ячейки c - элементы
+     * [offsets[c], offsets[c + 1]), клика ячейки c начинается с clique_offsets[c].
+     * Ребра, выходящие из ячейки из вершины exits[i], - [cut_edge_offsets[i], cut_edge_offsets[i + 1])
+    */
+    struct Overlay {
+        std::vector<uint32_t> entry_offsets;
+        std::vector<VertexId> entries;
+        std::vector<uint32_t> exit_offsets;
+        std::vector<VertexId> exits;
+        std::vector<size_t> clique_offsets;
+        std::vector<uint32_t> entry_positions; // Номер входной вершины в её ячейке, NO_POSITION - не входная
+        std::vector<uint32_t> exit_indexes; // Индекс выходной вершины в exits, NO_POSITION - не выходная
+        std::vector<size_t> cut_edge_offsets;
+        std::vector<EdgeId> cut_edges;
+    };
+    /**
+     * Предыдущая вершина пути и переход из неё: ребро edge орграфа при level == 0,
+     * иначе ребро клики ячейки уровня level
+    */
+    struct Parent {
+        VertexId vertex = 0;
+        EdgeId edge = 0;
+        size_t level = 0;
+    };
+    /**
+     * Состояние поиска, переиспользуемое между поисками: сбрасываются только затронутые вершины
+    */
+    struct SearchState {
+        explicit SearchState(size_t vertex_count)
+            : weights(vertex_count, INFINITE_WEIGHT)
+            , parents(vertex_count) {}
+
+        std::vector<Weight> weights;
+        std::vector<Parent> parents;
+        std::vector<VertexId> touched;
+    };
+
+    const Graph& graph_;
+    MultilevelData multilevel_data_;
+    std::vector<Overlay> overlays_; // Граничные вершины по уровням разбиения
+
+    void Partition();
+    static std::vector<uint32_t> GroupUnits(const UnitsAdjacency& adjacency,
+        const std::vector<size_t>& sizes, size_t max_size);
+    void InitializeOverlays();
+    bool IsValid() const;
+    void CustomizeCells(size_t level, uint32_t first_cell, size_t cells_step);
+
+    template <typename QueryLevel>
+    size_t RunSearch(SearchState& state, VertexId from, VertexId to, const QueryLevel& query_level,
+        size_t bound_level, uint32_t bound_cell) const;
+    void AppendEdges(SearchState& state, VertexId from, VertexId to, std::vector<EdgeId>& edges) const;
+    static void ResetState(SearchState& state);
+    uint32_t GetCell(size_t level, VertexId vertex) const;
+};
+
+template <typename Weight>
+MultilevelRouter<Weight>::MultilevelRouter(const Graph& graph, size_t threads_count)
+    : graph_(graph)
+{
+    if (graph_.GetVertexCount() >= NO_POSITION) {
+        throw std::length_error("Too many vertices for the multilevel partition");
+    }
+    Partition();
+    InitializeOverlays();
+    Customize(threads_count);
+}
+
+template <typename Weight>
+MultilevelRouter<Weight>::MultilevelRouter(const Graph& graph, MultilevelData multilevel_data)
+    : graph_(graph)
+    , multilevel_data_(std::move(multilevel_data))
+{
+    if (!IsValid()) {
+        throw std::invalid_argument("Multilevel data doesn't match the graph");
+    }
+    InitializeOverlays();
+    for (size_t level = 1; level <= overlays_.size(); ++level) {
+        if (multilevel_data_.levels[level - 1].clique_weights.size() != overlays_[level - 1].clique_offsets.back()) {
+            throw std::invalid_argument("Multilevel data doesn't match the graph");
+        }
+    }
+}
+
+/**
+ * Пересчитывает клики всех ячеек по текущим весам ребер орграфа снизу вверх по уровням:
+ * клика ячейки уровня рассчитывается поисками от её входных вершин по ребрам между
+ * ячейками предыдущего уровня и их кликам. Ячейки одного уровня независимы
+ * и распределяются между потоками по номеру ячейки
+*/
+template <typename Weight>
+void MultilevelRouter<Weight>::Customize(size_t threads_count) {
+    for (const auto& edge : graph_.GetEdges()) {
+        if (edge.weight < ZERO_WEIGHT) {
+            throw std::domain_error("Edges' weights should be non-negative");
+        }
+    }
+
+    for (size_t level = 1; level <= overlays_.size(); ++level) {
+        const Overlay& overlay = overlays_[level - 1];
+        multilevel_data_.levels[level - 1].clique_weights.assign(overlay.clique_offsets.back(), INFINITE_WEIGHT);
+
+        const size_t cell_count = overlay.entry_offsets.size() - 1;
+        const size_t level_threads_count = std::max<size_t>(1, std::min(threads_count, cell_count));
+        std::vector<std::thread> threads;
+        threads.reserve(level_threads_count - 1);
+        for (size_t thread_index = 1; thread_index < level_threads_count; ++thread_index) {
+            threads.emplace_back([this, level, thread_index, level_threads_count] {
+                CustomizeCells(level, static_cast<uint32_t>(thread_index), level_threads_count);
+            });
+        }
+        CustomizeCells(level, 0, level_threads_count);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+}
+
+/**
+ * Строит маршрут многоуровневым поиском Дейкстры. Уровень вершины в поиске - наибольший
+ * уровень, на котором её ячейка не содержит ни from, ни to. На нулевом уровне проходятся
+ * все исходящие ребра вершины, иначе - ребра клики её ячейки и ребра, выходящие из ячейки.
+ * Ребра клик найденного маршрута раскрываются в ребра орграфа
+*/
+template <typename Weight>
+std::optional<typename MultilevelRouter<Weight>::RouteInfo> MultilevelRouter<Weight>::BuildRoute(
+    VertexId from, VertexId to, SearchStats* stats) const {
+    const size_t vertex_count = graph_.GetVertexCount();
+    if (from >= vertex_count || to >= vertex_count) {
+        throw std::out_of_range("Vertex id is out of range");
+    }
+
+    // Ячейки вложены: если ячейка вершины на уровне содержит from или to,
+    // то и на всех следующих уровнях
+    const auto query_level = [this, from, to](VertexId vertex) {
+        for (size_t level = overlays_.size(); level > 0; --level) {
+            const uint32_t cell = GetCell(level, vertex);
+            if (cell != GetCell(level, from) && cell != GetCell(level, to)) {
+                return level;
+            }
+        }
+        return size_t{0};
+    };
+
+    // Состояние поиска хранится локально, поэтому метод можно вызывать конкурентно
+    SearchState state(vertex_count);
+    const size_t settled_count = RunSearch(state, from, to, query_level, 0, 0);
+    if (stats != nullptr) {
+        stats->settled_vertices = settled_count;
+    }
+    if (state.weights[to] == INFINITE_WEIGHT) {
+        return std::nullopt;
+    }
+
+    std::vector<EdgeId> edges;
+    AppendEdges(state, from, to, edges);
+    // Вес суммируется по ребрам в порядке пути, как при поиске по орграфу
+    Weight weight = ZERO_WEIGHT;
+    for (const EdgeId edge_id : edges) {
+        weight += graph_.GetEdge(edge_id).weight;
+    }
+    return RouteInfo{weight, std::move(edges)};
+}
+
+template <typename Weight>
+const typename MultilevelRouter<Weight>::MultilevelData& MultilevelRouter<Weight>::GetMultilevelData() const {
+    return multilevel_data_;
+}
+
+/**
+ * Разбивает вершины на вложенные ячейки. Ячейки первого уровня - группы вершин до
+ * FIRST_LEVEL_CELL_SIZE, каждого следующего - группы ячеек предыдущего уровня
+ * в CELL_SIZE_FACTOR раз большего размера. Уровни добавляются, пока ячеек больше CELL_SIZE_FACTOR
+ * и уровень хотя бы вдвое уменьшает число граничных вершин по сравнению с предыдущим
+ * (первый - с числом всех вершин): иначе поиск по кликам не быстрее поиска по ребрам.
+ * У сети без малых разрезов уровней может не быть, и поиск становится поиском Дейкстры
+*/
+template <typename Weight>
+void MultilevelRouter<Weight>::Partition() {
+    const size_t vertex_count = graph_.GetVertexCount();
+    // Единицы разбиения первого уровня - вершины
+    std::vector<uint32_t> vertex_units(vertex_count);
+    for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+        vertex_units[vertex] = static_cast<uint32_t>(vertex);
+    }
+    std::vector<size_t> sizes(vertex_count, 1);
+    size_t max_size = FIRST_LEVEL_CELL_SIZE;
+    size_t prev_boundary_count = vertex_count; // Число граничных вершин предыдущего уровня
+
+    while (sizes.size() > 1) {
+        UnitsAdjacency adjacency(sizes.size());
+        for (const auto& edge : graph_.GetEdges()) {
+            const uint32_t from_unit = vertex_units[edge.from];
+            const uint32_t to_unit = vertex_units[edge.to];
+            if (from_unit != to_unit) {
+                adjacency[from_unit].push_back({to_unit, 1});
+                adjacency[to_unit].push_back({from_unit, 1});
+            }
+        }
+
+        const std::vector<uint32_t> groups = GroupUnits(adjacency, sizes, max_size);
+        const size_t group_count = *std::max_element(groups.begin(), groups.end()) + size_t{1};
+        if (group_count == 1 || group_count == sizes.size()) {
+            break;
+        }
+
+        PartitionLevel level;
+        level.cells.resize(vertex_count);
+        for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+            level.cells[vertex] = groups[vertex_units[vertex]];
+        }
+        std::vector<bool> is_boundary(vertex_count, false);
+        for (const auto& edge : graph_.GetEdges()) {
+            if (level.cells[edge.from] != level.cells[edge.to]) {
+                is_boundary[edge.from] = true;
+                is_boundary[edge.to] = true;
+            }
+        }
+        const size_t boundary_count = static_cast<size_t>(std::count(is_boundary.begin(), is_boundary.end(), true));
+        if (2 * boundary_count > prev_boundary_count) {
+            break;
+        }
+        prev_boundary_count = boundary_count;
+        vertex_units = level.cells;
+        multilevel_data_.levels.push_back(std::move(level));
+
+        std::vector<size_t> group_sizes(group_count, 0);
+        for (uint32_t unit = 0; unit < sizes.size(); ++unit) {
+            group_sizes[groups[unit]] += sizes[unit];
+        }
+        sizes = std::move(group_sizes);
+        max_size *= CELL_SIZE_FACTOR;
+        if (group_count <= CELL_SIZE_FACTOR) {
+            break;
+        }
+    }
+}
+
+/**
+ * Объединяет единицы разбиения (вершины или ячейки предыдущего уровня) в группы до max_size вершин.
+ * Группа наращивается соседней единицей с наибольшим числом ребер в группу, пока та помещается.
+ * Затравки групп берутся в порядке обхода в ширину, поэтому соседние группы создаются
+ * друг за другом. Возвращает номер группы каждой единицы
+*/
+template <typename Weight>
+std::vector<uint32_t> MultilevelRouter<Weight>::GroupUnits(const UnitsAdjacency& adjacency,
+    const std::vector<size_t>& sizes, size_t max_size) {
+    const size_t unit_count = sizes.size();
+
+    // Порядок обхода в ширину по всем компонентам
+    std::vector<uint32_t> bfs_order;
+    bfs_order.reserve(unit_count);
+    std::vector<bool> visited(unit_count, false);
+    for (uint32_t root = 0; root < unit_count; ++root) {
+        if (visited[root]) {
+            continue;
+        }
+        visited[root] = true;
+        bfs_order.push_back(root);
+        for (size_t pos = bfs_order.size() - 1; pos < bfs_order.size(); ++pos) {
+            for (const auto& [neighbour, _] : adjacency[bfs_order[pos]]) {
+                if (!visited[neighbour]) {
+                    visited[neighbour] = true;
+                    bfs_order.push_back(neighbour);
+                }
+            }
+        }
+    }
+
+    std::vector<uint32_t> groups(unit_count, NO_POSITION);
+    std::vector<size_t> connections(unit_count, 0); // Число ребер единицы в растущую группу
+    uint32_t group_count = 0;
+    for (const uint32_t seed : bfs_order) {
+        if (groups[seed] != NO_POSITION) {
+            continue;
+        }
+        const uint32_t group = group_count++;
+        size_t group_size = 0;
+
+        std::vector<uint32_t> touched;
+        std::priority_queue<std::pair<size_t, uint32_t>> candidates;
+        candidates.push({0, seed});
+        while (!candidates.empty()) {
+            const auto [connection, unit] = candidates.top();
+            candidates.pop();
+            // Устаревшая запись очереди или единица, не помещающаяся в группу
+            if (groups[unit] != NO_POSITION || connection != connections[unit]
+                || group_size + sizes[unit] > max_size) {
+                continue;
+            }
+            groups[unit] = group;
+            group_size += sizes[unit];
+
+            for (const auto& [neighbour, count] : adjacency[unit]) {
+                if (groups[neighbour] != NO_POSITION) {
+                    continue;
+                }
+                if (connections[neighbour] == 0) {
+                    touched.push_back(neighbour);
+                }
+                connections[neighbour] += count;
+                candidates.push({connections[neighbour], neighbour});
+            }
+        }
+
+        for (const uint32_t unit : touched) {
+            connections[unit] = 0;
+        }
+    }
+    return groups;
+}
+
+/**
+ * Находит граничные вершины ячеек каждого уровня и смещения клик ячеек
+*/
+template <typename Weight>
+void MultilevelRouter<Weight>::InitializeOverlays() {
+    const size_t vertex_count = graph_.GetVertexCount();
+    overlays_.assign(multilevel_data_.levels.size(), {});
+
+    for (size_t level = 1; level <= overlays_.size(); ++level) {
+        const auto& cells = multilevel_data_.levels[level - 1].cells;
+        Overlay& overlay = overlays_[level - 1];
+
+        std::vector<bool> is_entry(vertex_count, false);
+        std::vector<bool> is_exit(vertex_count, false);
+        for (const auto& edge : graph_.GetEdges()) {
+            if (cells[edge.from] != cells[edge.to]) {
+                is_exit[edge.from] = true;
+                is_entry[edge.to] = true;
+            }
+        }
+
+        const size_t cell_count = vertex_count == 0 ? 0
+            : *std::max_element(cells.begin(), cells.end()) + size_t{1};
+        overlay.entry_offsets.assign(cell_count + 1, 0);
+        overlay.exit_offsets.assign(cell_count + 1, 0);
+        for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+            overlay.entry_offsets[cells[vertex] + 1] += is_entry[vertex];
+            overlay.exit_offsets[cells[vertex] + 1] += is_exit[vertex];
+        }
+        overlay.clique_offsets.assign(cell_count + 1, 0);
+        for (size_t cell = 0; cell < cell_count; ++cell) {
+            const size_t entries_count = overlay.entry_offsets[cell + 1];
+            const size_t exits_count = overlay.exit_offsets[cell + 1];
+            overlay.clique_offsets[cell + 1] = overlay.clique_offsets[cell] + entries_count * exits_count;
+            overlay.entry_offsets[cell + 1] += overlay.entry_offsets[cell];
+            overlay.exit_offsets[cell + 1] += overlay.exit_offsets[cell];
+        }
+
+        // Вершины обходятся по возрастанию id, поэтому граничные вершины ячеек упорядочены
+        overlay.entries.resize(overlay.entry_offsets.back());
+        overlay.exits.resize(overlay.exit_offsets.back());
+        overlay.entry_positions.assign(vertex_count, NO_POSITION);
+        overlay.exit_indexes.assign(vertex_count, NO_POSITION);
+        std::vector<uint32_t> entry_ends(overlay.entry_offsets.begin(), overlay.entry_offsets.end() - 1);
+        std::vector<uint32_t> exit_ends(overlay.exit_offsets.begin(), overlay.exit_offsets.end() - 1);
+        for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+            const uint32_t cell = cells[vertex];
+            if (is_entry[vertex]) {
+                overlay.entry_positions[vertex] = entry_ends[cell] - overlay.entry_offsets[cell];
+                overlay.entries[entry_ends[cell]++] = vertex;
+            }
+            if (is_exit[vertex]) {
+                overlay.exit_indexes[vertex] = exit_ends[cell];
+                overlay.exits[exit_ends[cell]++] = vertex;
+            }
+        }
+
+        overlay.cut_edge_offsets.assign(overlay.exits.size() + 1, 0);
+        for (size_t exit = 0; exit < overlay.exits.size(); ++exit) {
+            overlay.cut_edge_offsets[exit + 1] = overlay.cut_edge_offsets[exit];
+            for (const EdgeId edge_id : graph_.GetIncidentEdges(overlay.exits[exit])) {
+                const auto& edge = graph_.GetEdge(edge_id);
+                if (cells[edge.from] != cells[edge.to]) {
+                    overlay.cut_edges.push_back(edge_id);
+                    ++overlay.cut_edge_offsets[exit + 1];
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Проверяет, что ячейки заданы для каждой вершины, их номера не превышают числа вершин
+ * и каждая ячейка уровня целиком входит в одну ячейку следующего
+*/
+template <typename Weight>
+bool MultilevelRouter<Weight>::IsValid() const {
+    const size_t vertex_count = graph_.GetVertexCount();
+    const auto& levels = multilevel_data_.levels;
+    for (size_t level = 0; level < levels.size(); ++level) {
+        const auto& cells = levels[level].cells;
+        if (cells.size() != vertex_count
+            || std::any_of(cells.begin(), cells.end(), [vertex_count](uint32_t cell) { return cell >= vertex_count; })) {
+            return false;
+        }
+        if (level == 0) {
+            continue;
+        }
+        std::vector<uint32_t> parent_cells(vertex_count, NO_POSITION);
+        for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+            uint32_t& parent_cell = parent_cells[levels[level - 1].cells[vertex]];
+            if (parent_cell != NO_POSITION && parent_cell != cells[vertex]) {
+                return false;
+            }
+            parent_cell = cells[vertex];
+        }
+    }
+    return true;
+}
+
+/**
+ * Рассчитывает клики ячеек first_cell, first_cell + cells_step, ... уровня level
+*/
+template <typename Weight>
+void MultilevelRouter<Weight>::CustomizeCells(size_t level, uint32_t first_cell, size_t cells_step) {
+    const Overlay& overlay = overlays_[level - 1];
+    auto& clique_weights = multilevel_data_.levels[level - 1].clique_weights;
+    const size_t cell_count = overlay.entry_offsets.size() - 1;
+
+    // Внутри ячейки поиск ведется по ячейкам предыдущего уровня
+    const auto query_level = [level](VertexId) { return level - 1; };
+    SearchState state(graph_.GetVertexCount());
+    for (uint32_t cell = first_cell; cell < cell_count; cell += cells_step) {
+        const uint32_t exits_begin = overlay.exit_offsets[cell];
+        const size_t exits_count = overlay.exit_offsets[cell + 1] - exits_begin;
+        size_t clique_pos = overlay.clique_offsets[cell];
+
+        for (uint32_t entry = overlay.entry_offsets[cell]; entry < overlay.entry_offsets[cell + 1]; ++entry) {
+            RunSearch(state, overlay.entries[entry], NO_VERTEX, query_level, level, cell);
+            for (size_t exit = 0; exit < exits_count; ++exit) {
+                clique_weights[clique_pos++] = state.weights[overlay.exits[exits_begin + exit]];
+            }
+            ResetState(state);
+        }
+    }
+}
+
+/**
+ * Поиск Дейкстры от from до to (до исчерпания очереди при to == NO_VERTEX). Уровень вершины
+ * задает query_level: на нулевом уровне проходятся все исходящие ребра, иначе - клика ячейки
+ * этого уровня от входной вершины и ребра, выходящие из ячейки. При bound_level > 0 поиск
+ * не покидает ячейку bound_cell уровня bound_level. Возвращает число просмотренных вершин
+*/
+template <typename Weight>
+template <typename QueryLevel>
+size_t MultilevelRouter<Weight>::RunSearch(SearchState& state, VertexId from, VertexId to,
+    const QueryLevel& query_level, size_t bound_level, uint32_t bound_cell) const {
+    Queue queue;
+    const auto relax = [&](VertexId vertex, Weight weight, Parent parent) {
+        if ((bound_level > 0 && GetCell(bound_level, vertex) != bound_cell) || !(weight < state.weights[vertex])) {
+            return;
+        }
+        if (state.weights[vertex] == INFINITE_WEIGHT) {
+            state.touched.push_back(vertex);
+        }
+        state.weights[vertex] = weight;
+        state.parents[vertex] = parent;
+        queue.push({weight, vertex});
+    };
+
+    state.weights[from] = ZERO_WEIGHT;
+    state.touched.push_back(from);
+    queue.push({ZERO_WEIGHT, from});
+    size_t settled_count = 0;
+
+    while (!queue.empty()) {
+        const auto [weight, vertex] = queue.top();
+        queue.pop();
+        if (state.weights[vertex] < weight) {
+            continue;
+        }
+        ++settled_count;
+        // Вес до целевой вершины окончателен с момента её извлечения из очереди
+        if (vertex == to) {
+            break;
+        }
+
+        const size_t level = query_level(vertex);
+        if (level == 0) {
+            for (const EdgeId edge_id : graph_.GetIncidentEdges(vertex)) {
+                const auto& edge = graph_.GetEdge(edge_id);
+                relax(edge.to, weight + edge.weight, {vertex, edge_id, 0});
+            }
+        }
+        else {
+            const Overlay& overlay = overlays_[level - 1];
+            const uint32_t entry_position = overlay.entry_positions[vertex];
+            if (entry_position != NO_POSITION) {
+                const uint32_t cell = GetCell(level, vertex);
+                const uint32_t exits_begin = overlay.exit_offsets[cell];
+                const size_t exits_count = overlay.exit_offsets[cell + 1] - exits_begin;
+                const Weight* clique = multilevel_data_.levels[level - 1].clique_weights.data()
+                    + overlay.clique_offsets[cell] + entry_position * exits_count;
+                for (size_t exit = 0; exit < exits_count; ++exit) {
+                    if (clique[exit] != INFINITE_WEIGHT) {
+                        relax(overlay.exits[exits_begin + exit], weight + clique[exit], {vertex, 0, level});
+                    }
+                }
+            }
+            // Пути внутри ячейки уровня вершины учтены её кликой, проходятся только ребра из ячейки
+            const uint32_t exit_index = overlay.exit_indexes[vertex];
+            if (exit_index != NO_POSITION) {
+                for (size_t pos = overlay.cut_edge_offsets[exit_index]; pos < overlay.cut_edge_offsets[exit_index + 1]; ++pos) {
+                    const auto& edge = graph_.GetEdge(overlay.cut_edges[pos]);
+                    relax(edge.to, weight + edge.weight, {vertex, overlay.cut_edges[pos], 0});
+                }
+            }
+        }
+    }
+    return settled_count;
+}
+
+/**
+ * Добавляет в edges ребра орграфа пути from -> to, найденного поиском state. Ребро клики
+ * раскрывается повторным поиском внутри её ячейки по ячейкам предыдущего уровня.
+ * Состояние поиска сбрасывается
+*/
+template <typename Weight>
+void MultilevelRouter<Weight>::AppendEdges(SearchState& state, VertexId from, VertexId to,
+    std::vector<EdgeId>& edges) const {
+    std::vector<std::pair<Parent, VertexId>> steps;
+    for (VertexId vertex = to; vertex != from; vertex = state.parents[vertex].vertex) {
+        steps.emplace_back(state.parents[vertex], vertex);
+    }
+    ResetState(state);
+
+    for (auto it = steps.rbegin(); it != steps.rend(); ++it) {
+        const auto& [parent, vertex] = *it;
+        if (parent.level == 0) {
+            edges.push_back(parent.edge);
+            continue;
+        }
+        const size_t level = parent.level;
+        RunSearch(state, parent.vertex, vertex, [level](VertexId) { return level - 1; },
+            level, GetCell(level, parent.vertex));
+        AppendEdges(state, parent.vertex, vertex, edges);
+    }
+}
+
+template <typename Weight>
+void MultilevelRouter<Weight>::ResetState(SearchState& state) {
+    for (const VertexId vertex : state.touched) {
+        state.weights[vertex] = INFINITE_WEIGHT;
+    }
+    state.touched.clear();
+}
+
+template <typename Weight>
+uint32_t MultilevelRouter<Weight>::GetCell(size_t level, VertexId vertex) const {
+    return multilevel_data_.levels[level - 1].cells[vertex];
+}
+
+}  // namespace graph
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+/**
+ * Монотонная очередь с приоритетом по целочисленному беззнаковому ключу: ключ добавляемого
+ * элемента не меньше ключа последнего извлеченного, как в алгоритме Дейкстры.
+ * Элемент хранится в корзине по старшему биту, которым его ключ отличается от последнего
+ * извлеченного, поэтому за время жизни он перекладывается не больше числа бит ключа раз
+ * и без сравнений с другими элементами. Интерфейс повторяет std::priority_queue с std::greater
+*/
+template <typename Key, typename Value>
+class RadixHeap {
+    static_assert(std::is_integral_v<Key> && std::is_unsigned_v<Key>,
+        "Radix heap keys should be unsigned integers");
+
+public:
+    using value_type = std::pair<Key, Value>;
+
+    bool empty() const;
+    size_t size() const;
+
+    void push(const value_type& item);
+    const value_type& top();
+    void pop();
+
+private:
+    static constexpr size_t KEY_BITS = std::numeric_limits<Key>::digits;
+
+    // Корзина 0 - элементы с ключом, равным последнему извлеченному, корзина i - элементы,
+    // ключ которых впервые отличается от него в бите i - 1
+    std::array<std::vector<value_type>, KEY_BITS + 1> buckets_;
+    Key last_key_ = 0;
+    size_t size_ = 0;
+
+    size_t GetBucket(Key key) const;
+    void Refill();
+};
+
+template <typename Key, typename Value>
+bool RadixHeap<Key, Value>::empty() const {
+    return size_ == 0;
+}
+
+template <typename Key, typename Value>
+size_t RadixHeap<Key, Value>::size() const {
+    return size_;
+}
+
+template <typename Key, typename Value>
+void RadixHeap<Key, Value>::push(const value_type& item) {
+    if (item.first < last_key_) {
+        throw std::invalid_argument("Radix heap key should not be less than the last extracted one");
+    }
+    buckets_[GetBucket(item.first)].push_back(item);
+    ++size_;
+}
+
+/**
+ * Возвращает элемент с наименьшим ключом, при равных ключах - добавленный последним
+*/
+template <typename Key, typename Value>
+const typename RadixHeap<Key, Value>::value_type& RadixHeap<Key, Value>::top() {
+    Refill();
+    return buckets_[0].back();
+}
+
+template <typename Key, typename Value>
+void RadixHeap<Key, Value>::pop() {
+    Refill();
+    buckets_[0].pop_back();
+    --size_;
+}
+
+/**
+ * Возвращает номер корзины ключа - число значащих бит в его отличии от последнего извлеченного
+*/
+template <typename Key, typename Value>
+size_t RadixHeap<Key, Value>::GetBucket(Key key) const {
+    Key difference = key ^ last_key_;
+#if defined(__GNUC__)
+    if constexpr (sizeof(Key) <= sizeof(unsigned long long)) {
+        return difference == 0
+            ? 0
+            : std::numeric_limits<unsigned long long>::digits
+                - static_cast<size_t>(__builtin_clzll(static_cast<unsigned long long>(difference)));
+    }
+#endif
+    size_t bucket = 0;
+    while (difference != 0) {
+        difference >>= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+
+/**
+ * Если корзина 0 пуста - делает последним извлеченным наименьший ключ первой непустой корзины
+ * и раскладывает её элементы по корзинам младше неё
+*/
+template <typename Key, typename Value>
+void RadixHeap<Key, Value>::Refill() {
+    if (!buckets_[0].empty()) {
+        return;
+    }
+    if (size_ == 0) {
+        throw std::out_of_range("Radix heap is empty");
+    }
+
+    size_t bucket = 1;
+    while (buckets_[bucket].empty()) {
+        ++bucket;
+    }
+
+    // Все ключи корзины отличаются от нового последнего ключа в битах младше её номера,
+    // поэтому элементы попадают в младшие корзины, а сама корзина сохраняет выделенную память
+    std::vector<value_type>& items = buckets_[bucket];
+    last_key_ = items.front().first;
+    for (const auto& item : items) {
+        if (item.first < last_key_) {
+            last_key_ = item.first;
+        }
+    }
+    for (const auto& item : items) {
+        buckets_[GetBucket(item.first)].push_back(item);
+    }
+    items.clear();
+}
+
+}  // namespace graph
@@ -0,0 +1,238 @@
+#pragma once
+
+#include <algorithm>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+/**
+ * Маршрутизатор по расписанию алгоритмом RAPTOR. Вместо графа работает с линиями -
+ * последовательностями остановок, по которым ходят рейсы с заданным временем отправления.
+ * Поиск идет раундами: в раунде k найдено самое раннее прибытие на остановки не более
+ * чем с k поездками, каждая линия просматривается за раунд один раз
+*/
+template <typename Weight>
+class RaptorRouter {
+public:
+    using StopId = size_t;
+    using LineId = size_t;
+
+    /**
+     * Линия: остановки по порядку, время в пути между соседними остановками
+     * и время отправления рейсов с первой остановки
+    */
+    struct Line {
+        std::vector<StopId> stops;
+        std::vector<Weight> segment_times; // segment_times[i] - от stops[i] до stops[i + 1]
+        std::vector<Weight> departures;
+    };
+    /**
+     * Поездка по линии line от позиции board_pos до позиции alight_pos
+    */
+    struct Leg {
+        LineId line;
+        size_t board_pos;
+        size_t alight_pos;
+        Weight departure;
+        Weight arrival;
+    };
+    /**
+     * Найденный маршрут: время прибытия и поездки по порядку
+    */
+    struct Journey {
+        Weight arrival;
+        std::vector<Leg> legs;
+    };
+
+    RaptorRouter(size_t stop_count, std::vector<Line> lines);
+
+    std::optional<Journey> BuildJourney(StopId from, StopId to, Weight departure_time,
+        size_t max_transfers) const;
+
+    const Line& GetLine(LineId line) const;
+
+private:
+    static constexpr Weight INFINITE_WEIGHT = std::numeric_limits<Weight>::max();
+    static constexpr size_t NO_TRIP = std::numeric_limits<size_t>::max();
+
+    size_t stop_count_;
+    std::vector<Line> lines_;
+    // Время от отправления с первой остановки до каждой остановки линии
+    std::vector<std::vector<Weight>> lines_offsets_;
+    // Линии, проходящие через остановку, с позицией остановки в линии
+    std::vector<std::vector<std::pair<LineId, size_t>>> stops_lines_;
+
+    size_t FindEarliestTrip(LineId line, size_t pos, Weight ready_time) const;
+};
+
+template <typename Weight>
+RaptorRouter<Weight>::RaptorRouter(size_t stop_count, std::vector<Line> lines)
+    : stop_count_(stop_count)
+    , lines_(std::move(lines))
+    , stops_lines_(stop_count)
+{
+    lines_offsets_.reserve(lines_.size());
+    for (LineId line_id = 0; line_id < lines_.size(); ++line_id) {
+        Line& line = lines_[line_id];
+        if (line.stops.empty() || line.segment_times.size() + 1 != line.stops.size()) {
+            throw std::invalid_argument("Line should have a segment time between each pair of stops");
+        }
+        // Рейсы одной линии не обгоняют друг друга, поэтому порядок рейсов - порядок отправлений
+        std::sort(line.departures.begin(), line.departures.end());
+
+        std::vector<Weight> offsets(line.stops.size(), Weight{});
+        for (size_t pos = 0; pos < line.stops.size(); ++pos) {
+            if (line.stops[pos] >= stop_count_) {
+                throw std::out_of_range("Stop id is out of range");
+            }
+            if (pos > 0) {
+                offsets[pos] = offsets[pos - 1] + line.segment_times[pos - 1];
+            }
+            stops_lines_[line.stops[pos]].emplace_back(line_id, pos);
+        }
+        lines_offsets_.push_back(std::move(offsets));
+    }
+}
+
+/**
+ * Возвращает маршрут с самым ранним прибытием в to при отправлении из from не раньше
+ * departure_time и не более чем max_transfers пересадках, либо nullopt, если маршрута нет.
+ * Из маршрутов с одним временем прибытия выбирается маршрут с меньшим числом пересадок
+*/
+template <typename Weight>
+std::optional<typename RaptorRouter<Weight>::Journey> RaptorRouter<Weight>::BuildJourney(
+    StopId from, StopId to, Weight departure_time, size_t max_transfers) const {
+    if (from >= stop_count_ || to >= stop_count_) {
+        throw std::out_of_range("Stop id is out of range");
+    }
+    if (from == to) {
+        return Journey{departure_time, {}};
+    }
+
+    // Больше поездок, чем остановок, маршруту не нужно
+    const size_t max_rounds = max_transfers < stop_count_ ? max_transfers + 1 : stop_count_;
+
+    // Метки раундов: arrivals[k][stop] - самое раннее прибытие не более чем с k поездками,
+    // legs[k][stop] - поездка, которой остановка достигнута в раунде k.
+    // Состояние поиска хранится локально, поэтому метод можно вызывать конкурентно
+    std::vector<std::vector<Weight>> arrivals(1, std::vector<Weight>(stop_count_, INFINITE_WEIGHT));
+    std::vector<std::vector<std::optional<Leg>>> legs(1, std::vector<std::optional<Leg>>(stop_count_));
+    std::vector<Weight> best_arrivals(stop_count_, INFINITE_WEIGHT);
+
+    arrivals[0][from] = departure_time;
+    best_arrivals[from] = departure_time;
+    std::vector<bool> is_marked(stop_count_, false);
+    std::vector<StopId> marked_stops{from};
+    is_marked[from] = true;
+
+    // Для каждой линии - первая позиция, с которой её нужно просмотреть в раунде
+    std::vector<size_t> lines_start(lines_.size(), NO_TRIP);
+    std::vector<LineId> queued_lines;
+
+    for (size_t round = 1; round <= max_rounds && !marked_stops.empty(); ++round) {
+        arrivals.push_back(arrivals.back());
+        legs.emplace_back(stop_count_);
+        const auto& previous_arrivals = arrivals[round - 1];
+        auto& round_arrivals = arrivals[round];
+        auto& round_legs = legs[round];
+
+        // Собираем линии, проходящие через остановки, улучшенные в прошлом раунде
+        for (const StopId stop : marked_stops) {
+            is_marked[stop] = false;
+            for (const auto& [line_id, pos] : stops_lines_[stop]) {
+                if (lines_start[line_id] == NO_TRIP) {
+                    queued_lines.push_back(line_id);
+                    lines_start[line_id] = pos;
+                }
+                else {
+                    lines_start[line_id] = std::min(lines_start[line_id], pos);
+                }
+            }
+        }
+        marked_stops.clear();
+
+        for (const LineId line_id : queued_lines) {
+            const Line& line = lines_[line_id];
+            const auto& offsets = lines_offsets_[line_id];
+
+            size_t trip = NO_TRIP;
+            size_t board_pos = 0;
+            for (size_t pos = lines_start[line_id]; pos < line.stops.size(); ++pos) {
+                const StopId stop = line.stops[pos];
+
+                // Выход на остановке, если так она достигается раньше, чем известно
+                if (trip != NO_TRIP) {
+                    const Weight arrival = line.departures[trip] + offsets[pos];
+                    if (arrival < std::min(best_arrivals[stop], best_arrivals[to])) {
+                        round_arrivals[stop] = arrival;
+                        best_arrivals[stop] = arrival;
+                        round_legs[stop] = Leg{line_id, board_pos,
+                            pos, line.departures[trip] + offsets[board_pos], arrival};
+                        if (!is_marked[stop]) {
+                            is_marked[stop] = true;
+                            marked_stops.push_back(stop);
+                        }
+                    }
+                }
+
+                // Посадка на более ранний рейс, если на остановку успели в прошлом раунде
+                const Weight ready_time = previous_arrivals[stop];
+                if (ready_time == INFINITE_WEIGHT) {
+                    continue;
+                }
+                if (trip == NO_TRIP || ready_time <= line.departures[trip] + offsets[pos]) {
+                    const size_t earliest_trip = FindEarliestTrip(line_id, pos, ready_time);
+                    if (earliest_trip < trip) {
+                        trip = earliest_trip;
+                        board_pos = pos;
+                    }
+                }
+            }
+            lines_start[line_id] = NO_TRIP;
+        }
+        queued_lines.clear();
+    }
+
+    if (best_arrivals[to] == INFINITE_WEIGHT) {
+        return std::nullopt;
+    }
+
+    // Восстанавливаем поездки с конца: в каждом раунде метка либо перенесена
+    // из прошлого раунда, либо получена поездкой от остановки посадки
+    Journey journey{best_arrivals[to], {}};
+    StopId stop = to;
+    for (size_t round = arrivals.size() - 1; round > 0 && stop != from; --round) {
+        if (const auto& leg = legs[round][stop]) {
+            journey.legs.push_back(*leg);
+            stop = lines_[leg->line].stops[leg->board_pos];
+        }
+    }
+    std::reverse(journey.legs.begin(), journey.legs.end());
+
+    return journey;
+}
+
+template <typename Weight>
+const typename RaptorRouter<Weight>::Line& RaptorRouter<Weight>::GetLine(LineId line) const {
+    return lines_.at(line);
+}
+
+/**
+ * Возвращает номер первого рейса линии, отправляющегося с позиции pos не раньше ready_time,
+ * либо NO_TRIP, если такого рейса нет
+*/
+template <typename Weight>
+size_t RaptorRouter<Weight>::FindEarliestTrip(LineId line, size_t pos, Weight ready_time) const {
+    const auto& departures = lines_[line].departures;
+    const Weight offset = lines_offsets_[line][pos];
+
+    const auto it = std::lower_bound(departures.begin(), departures.end(), ready_time,
+        [offset](Weight departure, Weight time) { return departure + offset < time; });
+    return it == departures.end() ? NO_TRIP : static_cast<size_t>(it - departures.begin());
+}
+
+}  // namespace graph
@@ -38,6 +38,36 @@ void Handler::SerializeData() {
 		std::cerr << "Возникла ошибка сериализации" << std::endl;
 	}
 }
+/**
+ * Десериализует данные, добавляет в них новые маршруты и сериализует результат в тот же файл
+*/
+void Handler::UpdateSerializedData() {
+	// Инициилизируем обработчик json-запросов
+	JsonIOHandler json_handler(
+		catalogue_,
+		renderer_,
+		router_,
+		serializator_,
+		std::cin
+	);
+
+	// Считываем настройки сериализации из запроса
+	json_handler.ProcessSerializationSettingsRequest();
+
+	// Десериализуем данные
+	if (!serializator_.Deserialize()) {
+		std::cerr << "Возникла ошибка десериализации" << std::endl;
+		return;
+	}
+
+	// Добавляем маршруты, обновляя маршрутизатор без полного пересчета
+	json_handler.ProcessUpdateBaseRequests();
+
+	// Сериализуем обновленные данные
+	if (!serializator_.Serialize()) {
+		std::cerr << "Возникла ошибка сериализации" << std::endl;
+	}
+}
 /**
  * Десериализует данные, выводит резальтат обработки запросов
 */
@@ -16,6 +16,7 @@ public:
 	Handler(TransportCatalogue& catalogue);
 
 	void SerializeData();
+	void UpdateSerializedData();
 	void DeserializeAndProcessData();
 
 private:
@@ -1,26 +1,88 @@
 #pragma once
 
 #include "graph.h"
+#include "min_plus.h"
 
 #include <algorithm>
 #include <cassert>
+#include <condition_variable>
 #include <cstdint>
 #include <iterator>
+#include <limits>
+#include <mutex>
 #include <optional>
 #include <stdexcept>
+#include <thread>
+#include <type_traits>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
 namespace graph {
 
+namespace detail {
+
+/**
+ * Барьер синхронизации фиксированного числа потоков (аналог std::barrier из C++20)
+*/
+class Barrier {
+public:
+    explicit Barrier(size_t threads_count)
+        : threads_count_(threads_count) {
+    }
+
+    // Блокирует поток, пока все threads_count_ потоков не дойдут до барьера
+    void ArriveAndWait() {
+        std::unique_lock lock(mutex_);
+        const size_t generation = generation_;
+        if (++arrived_ == threads_count_) {
+            arrived_ = 0;
+            ++generation_;
+            condition_.notify_all();
+            return;
+        }
+        condition_.wait(lock, [this, generation] { return generation != generation_; });
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    const size_t threads_count_;
+    size_t arrived_ = 0;
+    size_t generation_ = 0;
+};
+
+}  // namespace detail
+
 template <typename Weight>
 class Router {
 private:
     using Graph = DirectedWeightedGraph<Weight>;
 
 public:
-    explicit Router(const Graph& graph);
+    // Последнее ребро маршрута в таблице хранится 32-битным индексом
+    using PrevEdgeId = uint32_t;
+
+    // Вес маршрута в таблице: веса double хранятся с одинарной точностью, что вдвое сокращает
+    // таблицу весов. Точный вес найденного маршрута BuildRoute суммирует по весам его ребер
+    using TableWeight = std::conditional_t<std::is_same_v<Weight, double>, float, Weight>;
+
+    // Вес отсутствующего маршрута
+    static constexpr TableWeight INFINITE_WEIGHT = std::numeric_limits<TableWeight>::has_infinity
+        ? std::numeric_limits<TableWeight>::infinity() : std::numeric_limits<TableWeight>::max();
+    // Последнее ребро маршрута без ребер (из вершины в себя) или отсутствующего маршрута
+    static constexpr PrevEdgeId NO_EDGE = std::numeric_limits<PrevEdgeId>::max();
+
+    // Таблица маршрутов между всеми парами вершин: два плоских массива
+    // размера vertex_count * vertex_count, построчно (строка - вершина, из которой строится маршрут)
+    struct RoutesInternalData {
+        size_t vertex_count = 0;
+        std::vector<TableWeight> weights;
+        std::vector<PrevEdgeId> prev_edges;
+    };
+
+    explicit Router(const Graph& graph, size_t threads_count = 1);
+    Router(const Graph& graph, RoutesInternalData routes_internal_data);
 
     struct RouteInfo {
         Weight weight;
@@ -28,90 +90,302 @@ public:
     };
 
     std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const;
+    void UpdateEdges(const std::vector<EdgeId>& edge_ids);
+
+    const RoutesInternalData& GetRoutesInternalData() const;
 
 private:
-    struct RouteInternalData {
-        Weight weight;
-        std::optional<EdgeId> prev_edge;
-    };
-    using RoutesInternalData = std::vector<std::vector<std::optional<RouteInternalData>>>;
+    // Сторона квадратного блока таблицы: три блока весов и ребер (~400 КБ) помещаются в кэш L2
+    static constexpr size_t BLOCK_SIZE = 128;
 
     void InitializeRoutesInternalData(const Graph& graph) {
         const size_t vertex_count = graph.GetVertexCount();
+        if (graph.GetEdgeCount() >= NO_EDGE) {
+            throw std::overflow_error("Too many edges for the routes table");
+        }
         for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
-            routes_internal_data_[vertex][vertex] = RouteInternalData{ZERO_WEIGHT, std::nullopt};
+            routes_internal_data_.weights[vertex * vertex_count + vertex] = ZERO_WEIGHT;
             for (const EdgeId edge_id : graph.GetIncidentEdges(vertex)) {
                 const auto& edge = graph.GetEdge(edge_id);
-                if (edge.weight < ZERO_WEIGHT) {
+                if (edge.weight < Weight{}) {
                     throw std::domain_error("Edges' weights should be non-negative");
                 }
-                auto& route_internal_data = routes_internal_data_[vertex][edge.to];
-                if (!route_internal_data || route_internal_data->weight > edge.weight) {
-                    route_internal_data = RouteInternalData{edge.weight, edge_id};
+                const size_t pos = vertex * vertex_count + edge.to;
+                const TableWeight edge_weight = static_cast<TableWeight>(edge.weight);
+                if (edge_weight < routes_internal_data_.weights[pos]) {
+                    routes_internal_data_.weights[pos] = edge_weight;
+                    routes_internal_data_.prev_edges[pos] = static_cast<PrevEdgeId>(edge_id);
                 }
             }
         }
     }
 
-    void RelaxRoute(VertexId vertex_from, VertexId vertex_to, const RouteInternalData& route_from,
-                    const RouteInternalData& route_to) {
-        auto& route_relaxing = routes_internal_data_[vertex_from][vertex_to];
-        const Weight candidate_weight = route_from.weight + route_to.weight;
-        if (!route_relaxing || candidate_weight < route_relaxing->weight) {
-            route_relaxing = {candidate_weight,
-                              route_to.prev_edge ? route_to.prev_edge : route_from.prev_edge};
+    // Релаксирует отрезок строки маршрутов через вершину, строки weights и weights_through различны.
+    // Маршрут через вершину заканчивается последним ребром маршрута из неё: NO_EDGE в
+    // prev_edges_through только у маршрута в саму вершину, а такой маршрут ничего не улучшает
+    static void RelaxRow(TableWeight* __restrict weights, PrevEdgeId* __restrict prev_edges,
+                         const TableWeight* __restrict weights_through,
+                         const PrevEdgeId* __restrict prev_edges_through,
+                         TableWeight weight_from, size_t count) {
+        // Для весов float используется векторизованное ядро
+        if constexpr (std::is_same_v<TableWeight, float> && std::is_same_v<PrevEdgeId, uint32_t>) {
+            detail::RelaxRowMinPlus(weights, prev_edges, weights_through, prev_edges_through,
+                                    weight_from, count);
+        }
+        else {
+            for (size_t pos = 0; pos < count; ++pos) {
+                if (weights_through[pos] == INFINITE_WEIGHT) {
+                    continue;
+                }
+                const TableWeight candidate_weight = weight_from + weights_through[pos];
+                if (candidate_weight < weights[pos]) {
+                    weights[pos] = candidate_weight;
+                    prev_edges[pos] = prev_edges_through[pos];
+                }
+            }
         }
     }
 
-    void RelaxRoutesInternalDataThroughVertex(size_t vertex_count, VertexId vertex_through) {
-        for (VertexId vertex_from = 0; vertex_from < vertex_count; ++vertex_from) {
-            if (const auto& route_from = routes_internal_data_[vertex_from][vertex_through]) {
-                for (VertexId vertex_to = 0; vertex_to < vertex_count; ++vertex_to) {
-                    if (const auto& route_to = routes_internal_data_[vertex_through][vertex_to]) {
-                        RelaxRoute(vertex_from, vertex_to, *route_from, *route_to);
+    // Релаксирует маршруты блока [from_begin, from_end) x [to_begin, to_end)
+    // через вершины [through_begin, through_end)
+    void RelaxBlock(VertexId from_begin, VertexId from_end, VertexId to_begin, VertexId to_end,
+                    VertexId through_begin, VertexId through_end) {
+        const size_t vertex_count = routes_internal_data_.vertex_count;
+        TableWeight* const weights = routes_internal_data_.weights.data();
+        PrevEdgeId* const prev_edges = routes_internal_data_.prev_edges.data();
+
+        for (VertexId vertex_through = through_begin; vertex_through < through_end; ++vertex_through) {
+            const size_t row_through = vertex_through * vertex_count;
+
+            for (VertexId vertex_from = from_begin; vertex_from < from_end; ++vertex_from) {
+                const size_t row = vertex_from * vertex_count;
+                const TableWeight weight_from = weights[row + vertex_through];
+                // Строка самой вершины через неё не улучшается: путь из вершины в себя нулевой
+                if (weight_from == INFINITE_WEIGHT || vertex_from == vertex_through) {
+                    continue;
+                }
+                RelaxRow(weights + row + to_begin, prev_edges + row + to_begin,
+                         weights + row_through + to_begin, prev_edges + row_through + to_begin,
+                         weight_from, to_end - to_begin);
+            }
+        }
+    }
+
+    // Блочный алгоритм Флойда-Уоршелла. Для каждого диагонального блока:
+    // 1) релаксируется сам блок; 2) блоки его строки и столбца; 3) все остальные блоки.
+    // Блоки внутри этапов 2 и 3 независимы и распределяются между threads_count потоками
+    // по номеру блока, поэтому результат не зависит от числа потоков
+    void RelaxRoutesInternalData(size_t threads_count) {
+        const size_t vertex_count = routes_internal_data_.vertex_count;
+        const size_t blocks_count = (vertex_count + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        detail::Barrier barrier(threads_count);
+
+        auto block_begin = [](size_t block) { return block * BLOCK_SIZE; };
+        auto block_end = [vertex_count](size_t block) {
+            return std::min(vertex_count, (block + 1) * BLOCK_SIZE);
+        };
+
+        auto worker = [&](size_t thread_index) {
+            for (size_t pivot = 0; pivot < blocks_count; ++pivot) {
+                const VertexId through_begin = block_begin(pivot);
+                const VertexId through_end = block_end(pivot);
+
+                if (thread_index == 0) {
+                    RelaxBlock(through_begin, through_end, through_begin, through_end,
+                               through_begin, through_end);
+                }
+                barrier.ArriveAndWait();
+
+                for (size_t block = thread_index; block < blocks_count; block += threads_count) {
+                    if (block == pivot) {
+                        continue;
+                    }
+                    RelaxBlock(through_begin, through_end, block_begin(block), block_end(block),
+                               through_begin, through_end);
+                    RelaxBlock(block_begin(block), block_end(block), through_begin, through_end,
+                               through_begin, through_end);
+                }
+                barrier.ArriveAndWait();
+
+                for (size_t block = thread_index; block < blocks_count * blocks_count;
+                     block += threads_count) {
+                    const size_t block_from = block / blocks_count;
+                    const size_t block_to = block % blocks_count;
+                    if (block_from == pivot || block_to == pivot) {
+                        continue;
                     }
+                    RelaxBlock(block_begin(block_from), block_end(block_from),
+                               block_begin(block_to), block_end(block_to),
+                               through_begin, through_end);
+                }
+                barrier.ArriveAndWait();
+            }
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(threads_count - 1);
+        for (size_t thread_index = 1; thread_index < threads_count; ++thread_index) {
+            threads.emplace_back(worker, thread_index);
+        }
+        worker(0);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    // Расширяет таблицу до числа вершин графа. Новые вершины еще не связаны ребрами:
+    // маршрут из них есть только в них самих
+    void ResizeRoutesInternalData() {
+        const size_t old_count = routes_internal_data_.vertex_count;
+        const size_t vertex_count = graph_.GetVertexCount();
+        if (vertex_count == old_count) {
+            return;
+        }
+
+        std::vector<TableWeight> weights(vertex_count * vertex_count, INFINITE_WEIGHT);
+        std::vector<PrevEdgeId> prev_edges(vertex_count * vertex_count, NO_EDGE);
+        for (VertexId vertex_from = 0; vertex_from < vertex_count; ++vertex_from) {
+            if (vertex_from >= old_count) {
+                weights[vertex_from * vertex_count + vertex_from] = ZERO_WEIGHT;
+                continue;
+            }
+            std::copy_n(routes_internal_data_.weights.begin() + vertex_from * old_count, old_count,
+                        weights.begin() + vertex_from * vertex_count);
+            std::copy_n(routes_internal_data_.prev_edges.begin() + vertex_from * old_count, old_count,
+                        prev_edges.begin() + vertex_from * vertex_count);
+        }
+        routes_internal_data_ = {vertex_count, std::move(weights), std::move(prev_edges)};
+    }
+
+    // Релаксирует таблицу через ребро from -> to: маршрут x -> y улучшается, если путь
+    // x -> from -> to -> y короче. Ребро полезно только для столбцов y, маршрут до которых
+    // из from через ребро короче, и строк x, маршрут из которых до to через ребро короче:
+    // иначе путь через ребро не короче уже найденного по неравенству треугольника
+    void RelaxEdge(EdgeId edge_id) {
+        const size_t vertex_count = routes_internal_data_.vertex_count;
+        TableWeight* const weights = routes_internal_data_.weights.data();
+        PrevEdgeId* const prev_edges = routes_internal_data_.prev_edges.data();
+        const auto& edge = graph_.GetEdge(edge_id);
+        const TableWeight edge_weight = static_cast<TableWeight>(edge.weight);
+        const size_t row_edge_from = edge.from * vertex_count;
+        const size_t row_edge_to = edge.to * vertex_count;
+
+        std::vector<VertexId> columns;
+        for (VertexId vertex_to = 0; vertex_to < vertex_count; ++vertex_to) {
+            const TableWeight weight_through = weights[row_edge_to + vertex_to];
+            if (weight_through != INFINITE_WEIGHT
+                && edge_weight + weight_through < weights[row_edge_from + vertex_to]) {
+                columns.push_back(vertex_to);
+            }
+        }
+        if (columns.empty()) {
+            return;
+        }
+
+        for (VertexId vertex_from = 0; vertex_from < vertex_count; ++vertex_from) {
+            const size_t row = vertex_from * vertex_count;
+            if (weights[row + edge.from] == INFINITE_WEIGHT) {
+                continue;
+            }
+            const TableWeight weight_from = weights[row + edge.from] + edge_weight;
+            if (!(weight_from < weights[row + edge.to])) {
+                continue;
+            }
+            for (const VertexId vertex_to : columns) {
+                const TableWeight candidate_weight = weight_from + weights[row_edge_to + vertex_to];
+                if (candidate_weight < weights[row + vertex_to]) {
+                    weights[row + vertex_to] = candidate_weight;
+                    prev_edges[row + vertex_to] = vertex_to == edge.to
+                        ? static_cast<PrevEdgeId>(edge_id) : prev_edges[row_edge_to + vertex_to];
                 }
             }
         }
     }
 
-    static constexpr Weight ZERO_WEIGHT{};
+    static constexpr TableWeight ZERO_WEIGHT{};
     const Graph& graph_;
     RoutesInternalData routes_internal_data_;
 };
 
 template <typename Weight>
-Router<Weight>::Router(const Graph& graph)
+Router<Weight>::Router(const Graph& graph, size_t threads_count)
     : graph_(graph)
-    , routes_internal_data_(graph.GetVertexCount(),
-                            std::vector<std::optional<RouteInternalData>>(graph.GetVertexCount()))
+    , routes_internal_data_{graph.GetVertexCount(),
+                            std::vector<TableWeight>(graph.GetVertexCount() * graph.GetVertexCount(),
+                                                     INFINITE_WEIGHT),
+                            std::vector<PrevEdgeId>(graph.GetVertexCount() * graph.GetVertexCount(),
+                                                    NO_EDGE)}
 {
     InitializeRoutesInternalData(graph);
 
+    const size_t blocks_count = (graph.GetVertexCount() + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    RelaxRoutesInternalData(std::max<size_t>(1, std::min(threads_count, blocks_count)));
+}
+
+template <typename Weight>
+Router<Weight>::Router(const Graph& graph, RoutesInternalData routes_internal_data)
+    : graph_(graph)
+    , routes_internal_data_(std::move(routes_internal_data))
+{
     const size_t vertex_count = graph.GetVertexCount();
-    for (VertexId vertex_through = 0; vertex_through < vertex_count; ++vertex_through) {
-        RelaxRoutesInternalDataThroughVertex(vertex_count, vertex_through);
+    if (routes_internal_data_.vertex_count != vertex_count
+        || routes_internal_data_.weights.size() != vertex_count * vertex_count
+        || routes_internal_data_.prev_edges.size() != vertex_count * vertex_count) {
+        throw std::invalid_argument("Routes internal data doesn't match the graph");
     }
 }
 
 template <typename Weight>
 std::optional<typename Router<Weight>::RouteInfo> Router<Weight>::BuildRoute(VertexId from,
                                                                              VertexId to) const {
-    const auto& route_internal_data = routes_internal_data_.at(from).at(to);
-    if (!route_internal_data) {
+    const size_t vertex_count = routes_internal_data_.vertex_count;
+    if (from >= vertex_count || to >= vertex_count) {
+        throw std::out_of_range("Vertex id is out of range");
+    }
+    if (routes_internal_data_.weights[from * vertex_count + to] == INFINITE_WEIGHT) {
         return std::nullopt;
     }
-    const Weight weight = route_internal_data->weight;
     std::vector<EdgeId> edges;
-    for (std::optional<EdgeId> edge_id = route_internal_data->prev_edge;
-         edge_id;
-         edge_id = routes_internal_data_[from][graph_.GetEdge(*edge_id).from]->prev_edge)
+    for (PrevEdgeId edge_id = routes_internal_data_.prev_edges[from * vertex_count + to];
+         edge_id != NO_EDGE;
+         edge_id = routes_internal_data_.prev_edges[from * vertex_count + graph_.GetEdge(edge_id).from])
     {
-        edges.push_back(*edge_id);
+        edges.push_back(edge_id);
     }
     std::reverse(edges.begin(), edges.end());
 
+    // Вес суммируется по ребрам от начала маршрута, как при поиске по графу
+    Weight weight{};
+    for (const EdgeId edge_id : edges) {
+        weight += graph_.GetEdge(edge_id).weight;
+    }
     return RouteInfo{weight, std::move(edges)};
 }
 
+/**
+ * Обновляет таблицу после добавления в граф вершин и ребер edge_ids или уменьшения
+ * весов ребер edge_ids. Каждое ребро релаксирует таблицу за O(V^2) вместо полного пересчета
+*/
+template <typename Weight>
+void Router<Weight>::UpdateEdges(const std::vector<EdgeId>& edge_ids) {
+    if (graph_.GetEdgeCount() >= NO_EDGE) {
+        throw std::overflow_error("Too many edges for the routes table");
+    }
+    for (const EdgeId edge_id : edge_ids) {
+        if (graph_.GetEdge(edge_id).weight < Weight{}) {
+            throw std::domain_error("Edges' weights should be non-negative");
+        }
+    }
+
+    ResizeRoutesInternalData();
+    for (const EdgeId edge_id : edge_ids) {
+        RelaxEdge(edge_id);
+    }
+}
+
+template <typename Weight>
+const typename Router<Weight>::RoutesInternalData& Router<Weight>::GetRoutesInternalData() const {
+    return routes_internal_data_;
+}
+
 }  // namespace graph
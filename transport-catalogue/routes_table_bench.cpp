@@ -0,0 +1,178 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "graph.h"
+#include "router.h"
+
+/**
+ * Бенчмарк таблицы маршрутов all_pairs: прежнее представление - вектор строк
+ * из std::optional ячеек с простым алгоритмом Флойда-Уоршелла - против плоских массивов
+ * graph::Router с блочным расчетом и весами одинарной точности. Выводит время расчета и объем
+ * таблицы, сверяет веса маршрутов и наибольшее относительное отклонение от прежней таблицы.
+ * Запуск: routes_table_bench [V ...], по умолчанию V = 1000 2000 3000
+*/
+
+using namespace std::literals;
+
+namespace {
+
+/**
+ * Таблица маршрутов в прежнем представлении: строка на вершину, ячейка - необязательные вес
+ * и последнее ребро маршрута
+*/
+class LegacyRoutesTable {
+public:
+    struct RouteInternalData {
+        double weight;
+        std::optional<graph::EdgeId> prev_edge;
+    };
+    using Row = std::vector<std::optional<RouteInternalData>>;
+
+    explicit LegacyRoutesTable(const graph::DirectedWeightedGraph<double>& graph)
+        : rows_(graph.GetVertexCount(), Row(graph.GetVertexCount())) {
+        const size_t vertex_count = graph.GetVertexCount();
+        for (graph::VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+            rows_[vertex][vertex] = RouteInternalData{ 0.0, std::nullopt };
+            for (const graph::EdgeId edge_id : graph.GetIncidentEdges(vertex)) {
+                const auto& edge = graph.GetEdge(edge_id);
+                auto& route = rows_[vertex][edge.to];
+                if (!route || route->weight > edge.weight) {
+                    route = RouteInternalData{ edge.weight, edge_id };
+                }
+            }
+        }
+
+        for (graph::VertexId vertex_through = 0; vertex_through < vertex_count; ++vertex_through) {
+            for (graph::VertexId vertex_from = 0; vertex_from < vertex_count; ++vertex_from) {
+                const auto& route_from = rows_[vertex_from][vertex_through];
+                if (!route_from) {
+                    continue;
+                }
+                for (graph::VertexId vertex_to = 0; vertex_to < vertex_count; ++vertex_to) {
+                    const auto& route_to = rows_[vertex_through][vertex_to];
+                    if (!route_to) {
+                        continue;
+                    }
+                    auto& route = rows_[vertex_from][vertex_to];
+                    const double candidate_weight = route_from->weight + route_to->weight;
+                    if (!route || candidate_weight < route->weight) {
+                        route = RouteInternalData{ candidate_weight,
+                            route_to->prev_edge ? route_to->prev_edge : route_from->prev_edge };
+                    }
+                }
+            }
+        }
+    }
+
+    const std::optional<RouteInternalData>& GetRoute(graph::VertexId from, graph::VertexId to) const {
+        return rows_[from][to];
+    }
+
+    size_t GetMemoryUsage() const {
+        return rows_.size() * (sizeof(Row) + rows_.size() * sizeof(std::optional<RouteInternalData>));
+    }
+
+private:
+    std::vector<Row> rows_;
+};
+
+/**
+ * Создает граф, похожий на орграф справочника: пара вершин входа и выхода на остановку с ребром
+ * ожидания и ребра поездок к остановкам неподалеку по номеру
+*/
+graph::DirectedWeightedGraph<double> MakeTransitGraph(size_t vertex_count) {
+    std::mt19937 generator(7);
+    std::uniform_real_distribution<double> weight_distribution(1.0, 30.0);
+    const size_t stops_count = vertex_count / 2;
+
+    graph::DirectedWeightedGraph<double> graph(vertex_count);
+    for (size_t stop = 0; stop < stops_count; ++stop) {
+        graph.AddEdge({ 2 * stop, 2 * stop + 1, 6.0 });
+    }
+    for (size_t ride = 0; ride < vertex_count * 4; ++ride) {
+        const size_t from = generator() % stops_count;
+        const size_t to = (from + 1 + generator() % 40) % stops_count;
+        graph.AddEdge({ 2 * from + 1, 2 * to, weight_distribution(generator) });
+    }
+    graph.Freeze();
+    return graph;
+}
+
+double GetSeconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    std::vector<size_t> vertex_counts;
+    for (int arg = 1; arg < argc; ++arg) {
+        vertex_counts.push_back(std::stoul(argv[arg]));
+    }
+    if (vertex_counts.empty()) {
+        vertex_counts = { 1000, 2000, 3000 };
+    }
+
+    bool is_matching = true;
+    std::cout << std::fixed << std::setprecision(2);
+    for (const size_t vertex_count : vertex_counts) {
+        if (vertex_count < 2) {
+            std::cerr << "V must be at least 2\n"sv;
+            return 1;
+        }
+        const auto graph = MakeTransitGraph(vertex_count);
+
+        auto start = std::chrono::steady_clock::now();
+        const LegacyRoutesTable legacy_table(graph);
+        const double legacy_time = GetSeconds(start);
+
+        start = std::chrono::steady_clock::now();
+        const graph::Router<double> router(graph);
+        const double flat_time = GetSeconds(start);
+
+        const auto& routes = router.GetRoutesInternalData();
+        const size_t flat_memory = routes.weights.size() * sizeof(graph::Router<double>::TableWeight)
+            + routes.prev_edges.size() * sizeof(graph::Router<double>::PrevEdgeId);
+        const size_t legacy_memory = legacy_table.GetMemoryUsage();
+
+        // Таблица сравнивает веса с одинарной точностью, поэтому из почти равных маршрутов
+        // может выбрать чуть более длинный: веса маршрутов сверяются с относительной погрешностью
+        size_t mismatches = 0;
+        double max_error = 0.0;
+        for (graph::VertexId from = 0; from < vertex_count; ++from) {
+            for (graph::VertexId to = 0; to < vertex_count; ++to) {
+                const auto& legacy_route = legacy_table.GetRoute(from, to);
+                const auto route = router.BuildRoute(from, to);
+                if (legacy_route.has_value() != route.has_value()) {
+                    ++mismatches;
+                    continue;
+                }
+                if (route && legacy_route->weight > 0.0) {
+                    const double error = std::abs(route->weight - legacy_route->weight) / legacy_route->weight;
+                    max_error = std::max(max_error, error);
+                    if (error > 1e-5) {
+                        ++mismatches;
+                    }
+                }
+            }
+        }
+        is_matching = is_matching && mismatches == 0;
+
+        std::cout << "V="sv << vertex_count
+            << " legacy "sv << legacy_time << " s, "sv << legacy_memory / 1048576.0 << " MiB"sv
+            << " | flat "sv << flat_time << " s, "sv << flat_memory / 1048576.0 << " MiB"sv
+            << " | memory "sv << static_cast<double>(legacy_memory) / static_cast<double>(flat_memory) << 'x'
+            << ", max error "sv << std::scientific << max_error << std::fixed
+            << ", mismatches "sv << mismatches << '\n';
+    }
+
+    return is_matching ? 0 : 1;
+}
@@ -50,6 +50,13 @@ bool Serializator::Serialize() {
     SaveRouterSettings(data_to_save->mutable_router_settings());
     SaveRouterInfo(data_to_save->mutable_router_info());
     SaveGraphInfo(data_to_save->mutable_graph());
+    SaveRoutesTable(data_to_save->mutable_routes_table());
+    SaveCompactRoutesTable(data_to_save->mutable_compact_routes_table());
+    SaveContractionHierarchy(data_to_save->mutable_contraction_hierarchy());
+    SaveLandmarks(data_to_save->mutable_landmarks());
+    SaveMultilevelPartition(data_to_save->mutable_multilevel_partition());
+    SaveComponents(data_to_save->mutable_components());
+    SaveHubLabels(data_to_save->mutable_hub_labels());
 
     // Сериализует полученные данные в поток вывода ofs
     data_to_save->SerializeToOstream(&ofs);
@@ -84,6 +91,13 @@ bool Serializator::Deserialize() {
     // Десериализует данные маршрутизатора
     DeserializeRouteSettings(*data.mutable_router_settings());
     DeserializeRouterInfo(*data.mutable_router_info());
+    DeserializeRoutesTable(*data.mutable_routes_table());
+    DeserializeCompactRoutesTable(*data.mutable_compact_routes_table());
+    DeserializeContractionHierarchy(*data.mutable_contraction_hierarchy());
+    DeserializeLandmarks(*data.mutable_landmarks());
+    DeserializeMultilevelPartition(*data.mutable_multilevel_partition());
+    DeserializeComponents(*data.mutable_components());
+    DeserializeHubLabels(*data.mutable_hub_labels());
     DeserializeGraphInfo(*data.mutable_graph());
 
     return true;
@@ -107,23 +121,24 @@ void Serializator::SaveStopsInfo(transport_catalogue_ser::TransportCatalogue* da
     }
 }
 /**
- * Запись данных о маршрутах
+ * Запись данных о маршрутах. Маршруты записываются в порядке добавления в справочник,
+ * поэтому после десериализации их индексы, на которые ссылаются ребра маршрутизатора, сохраняются
 */
 void Serializator::SaveRoutesInfo(transport_catalogue_ser::TransportCatalogue* data_to_save) {
-    uint32_t i = 0;
-    for (const auto& [_, data] : catalogue_.GetRoutesMap()) {
+    for (const auto& route : catalogue_.GetRoutes()) {
         transport_catalogue_ser::Route* route_to_save = data_to_save->add_routes();
 
-        route_to_save->set_name(data->number);
-        route_to_save->set_is_round(data->is_round);
+        route_to_save->set_name(route.number);
+        route_to_save->set_is_round(route.is_round);
 
-        for (const auto& stop : data->stops) {
+        for (const auto& stop : route.stops) {
             route_to_save->add_stops_ids(
                 stops_to_ids_[stop->name]
             );
         }
-
-        routes_to_ids_[data->number] = i;
+        for (const double departure : route.departures) {
+            route_to_save->add_departures(departure);
+        }
     }
 }
 /**
@@ -192,12 +207,11 @@ void Serializator::DeserializeRoutesInfo(transport_catalogue_ser::TransportCatal
             );
         }
 
-        ids_to_routes_[i] = route->name();
-
         catalogue_.AddRoute({
             route->name(),
             route->is_round(),
-            stops
+            stops,
+            std::vector<double>(route->departures().begin(), route->departures().end())
         });
     }
 }
@@ -329,6 +343,12 @@ void Serializator::SaveRouterSettings(transport_catalogue_ser::RouteSettings* da
 
     data->set_wait_time(settings.wait_time);
     data->set_velocity(settings.velocity);
+    data->set_router_type(static_cast<int32_t>(settings.router_type));
+    data->set_graph_model(static_cast<int32_t>(settings.graph_model));
+    data->set_route_cache_size(settings.route_cache_size);
+    data->set_landmark_count(settings.landmark_count);
+    data->set_hub_labels(settings.hub_labels);
+    data->set_integer_weights(settings.integer_weights);
 }
 /**
  * Записывает данные маршрутизатора
@@ -339,13 +359,10 @@ void Serializator::SaveRouterInfo(transport_catalogue_ser::RouterInfo* data) {
     for (const EdgeInfo& edge : edges) {
         transport_catalogue_ser::EdgeInfo* to_add = data->add_edges();
 
-        to_add->set_weight(edge.weight);
-        to_add->set_name_id(edge.type == EdgeType::BUS
-            ? routes_to_ids_[edge.name]
-            : stops_to_ids_[edge.name]
-        );
+        to_add->set_name_id(edge.name_id);
         to_add->set_span_count(edge.span_count);
-        to_add->set_type(edge.type == EdgeType::BUS ? 1 : 2);
+        to_add->set_type(static_cast<int32_t>(edge.type) + 1);
+        to_add->set_distance(edge.distance);
     }
 }
 /**
@@ -363,15 +380,151 @@ void Serializator::SaveGraphInfo(transport_catalogue_ser::Graph* data) {
         to_add->set_weight(edge.weight);
     }
 
-    // Сохраняет список смежностей
-    for (const auto& list : graph.GetIncidenceLists()) {
-        transport_catalogue_ser::Incidence* incidence = data->add_incidence_lists();
+    // Сохраняет сжатое представление списков смежностей
+    for (size_t offset : graph.GetIncidenceOffsets()) {
+        data->add_incidence_offsets(offset);
+    }
+    for (graph::EdgeId edge : graph.GetIncidenceEdges()) {
+        data->add_incidence_edges(edge);
+    }
+}
 
-        for (graph::EdgeId edge : list) {
-            incidence->add_incidence(edge);
-        }
+/**
+ * Записывает рассчитанную таблицу маршрутов между всеми парами вершин
+*/
+void Serializator::SaveRoutesTable(transport_catalogue_ser::RoutesTable* data) {
+    const TransportRouter::RoutesTable* routes_table = router_.GetRoutesTable();
+    // Если движок маршрутизации не рассчитывает таблицу - записывать нечего
+    if (routes_table == nullptr) {
+        return;
+    }
+    using Router = graph::Router<double>;
+
+    const size_t cells_count = routes_table->weights.size();
+    data->set_vertex_count(routes_table->vertex_count);
+    data->mutable_weights()->Reserve(cells_count);
+    data->mutable_prev_edges()->Reserve(cells_count);
+
+    for (size_t pos = 0; pos < cells_count; ++pos) {
+        const Router::TableWeight weight = routes_table->weights[pos];
+        const Router::PrevEdgeId prev_edge = routes_table->prev_edges[pos];
+
+        data->add_weights(weight == Router::INFINITE_WEIGHT ? 0.0f : weight);
+        data->add_prev_edges(weight == Router::INFINITE_WEIGHT
+            ? 0
+            : (prev_edge == Router::NO_EDGE ? 1 : static_cast<uint64_t>(prev_edge) + 2)
+        );
     }
 }
+/**
+ * Записывает сжатую таблицу последних ребер маршрутов между всеми парами вершин
+*/
+void Serializator::SaveCompactRoutesTable(transport_catalogue_ser::CompactRoutesTable* data) {
+    const TransportRouter::CompactRoutesTable* compact_routes_table = router_.GetCompactRoutesTable();
+    // Если движок маршрутизации не рассчитывает таблицу - записывать нечего
+    if (compact_routes_table == nullptr) {
+        return;
+    }
+
+    data->set_vertex_count(compact_routes_table->vertex_count);
+    data->set_cell_size(static_cast<uint32_t>(compact_routes_table->cell_size));
+    data->set_cells(compact_routes_table->cells.data(), compact_routes_table->cells.size());
+}
+/**
+ * Записывает иерархию сжатий графа
+*/
+void Serializator::SaveContractionHierarchy(transport_catalogue_ser::ContractionHierarchy* data) {
+    const TransportRouter::ContractionData* contraction_data = router_.GetContractionData();
+    // Если движок маршрутизации не строит иерархию - записывать нечего
+    if (contraction_data == nullptr) {
+        return;
+    }
+
+    data->mutable_ranks()->Reserve(static_cast<int>(contraction_data->ranks.size()));
+    for (size_t rank : contraction_data->ranks) {
+        data->add_ranks(rank);
+    }
+
+    data->mutable_shortcuts()->Reserve(static_cast<int>(contraction_data->shortcuts.size()));
+    for (const auto& shortcut : contraction_data->shortcuts) {
+        transport_catalogue_ser::Shortcut* to_add = data->add_shortcuts();
+
+        to_add->set_from(shortcut.from);
+        to_add->set_to(shortcut.to);
+        to_add->set_weight(shortcut.weight);
+        to_add->set_first_edge(shortcut.first_edge);
+        to_add->set_second_edge(shortcut.second_edge);
+    }
+}
+/**
+ * Записывает ориентиры ALT и веса путей до них
+*/
+void Serializator::SaveLandmarks(transport_catalogue_ser::Landmarks* data) {
+    const TransportRouter::LandmarkData* landmark_data = router_.GetLandmarkData();
+    // Если движок маршрутизации не рассчитывает ориентиры - записывать нечего
+    if (landmark_data == nullptr) {
+        return;
+    }
+
+    data->mutable_landmarks()->Add(landmark_data->landmarks.begin(), landmark_data->landmarks.end());
+    data->mutable_from_landmarks()->Add(landmark_data->from_landmarks.begin(),
+        landmark_data->from_landmarks.end());
+    data->mutable_to_landmarks()->Add(landmark_data->to_landmarks.begin(),
+        landmark_data->to_landmarks.end());
+}
+/**
+ * Записывает разбиение орграфа на ячейки и клики ячеек
+*/
+void Serializator::SaveMultilevelPartition(transport_catalogue_ser::MultilevelPartition* data) {
+    const TransportRouter::MultilevelData* multilevel_data = router_.GetMultilevelData();
+    // Если движок маршрутизации не разбивает орграф - записывать нечего
+    if (multilevel_data == nullptr) {
+        return;
+    }
+
+    for (const auto& level : multilevel_data->levels) {
+        transport_catalogue_ser::PartitionLevel* level_to_save = data->add_levels();
+        level_to_save->mutable_cells()->Add(level.cells.begin(), level.cells.end());
+        level_to_save->mutable_clique_weights()->Add(level.clique_weights.begin(), level.clique_weights.end());
+    }
+}
+
+/**
+ * Записывает метки индекса хабов
+*/
+void Serializator::SaveHubLabels(transport_catalogue_ser::HubLabels* data) {
+    const TransportRouter::HubLabelsData* hub_labels_data = router_.GetHubLabelsData();
+    // Если индекс хабов не строится - записывать нечего
+    if (hub_labels_data == nullptr) {
+        return;
+    }
+
+    const auto save_labels = [](const graph::HubLabels<double>::Labels& labels,
+        transport_catalogue_ser::HubLabelsSet* labels_data) {
+        labels_data->mutable_offsets()->Add(labels.offsets.begin(), labels.offsets.end());
+        labels_data->mutable_hubs()->Add(labels.hubs.begin(), labels.hubs.end());
+        labels_data->mutable_weights()->Add(labels.weights.begin(), labels.weights.end());
+    };
+
+    data->mutable_order()->Add(hub_labels_data->order.begin(), hub_labels_data->order.end());
+    save_labels(hub_labels_data->forward_labels, data->mutable_forward_labels());
+    save_labels(hub_labels_data->backward_labels, data->mutable_backward_labels());
+}
+/**
+ * Записывает компоненты связности орграфа
+*/
+void Serializator::SaveComponents(transport_catalogue_ser::Components* data) {
+    const TransportRouter::ComponentsData* components_data = router_.GetComponentsData();
+    // Если орграф не создан - записывать нечего
+    if (components_data == nullptr) {
+        return;
+    }
+
+    data->mutable_weak_components()->Add(components_data->weak_components.begin(),
+        components_data->weak_components.end());
+    data->mutable_strong_components()->Add(components_data->strong_components.begin(),
+        components_data->strong_components.end());
+}
 
 /**
  * Десериализует данные о настройках маршрутизатора
@@ -379,7 +532,14 @@ void Serializator::SaveGraphInfo(transport_catalogue_ser::Graph* data) {
 void Serializator::DeserializeRouteSettings(transport_catalogue_ser::RouteSettings& data) {
     router_.SetRouteSettings({
         data.wait_time(),
-        data.velocity()
+        data.velocity(),
+        static_cast<RouterType>(data.router_type()),
+        static_cast<GraphModel>(data.graph_model()),
+        1,
+        data.route_cache_size(),
+        data.landmark_count(),
+        data.hub_labels(),
+        data.integer_weights()
     });
 }
 /**
@@ -387,15 +547,16 @@ void Serializator::DeserializeRouteSettings(transport_catalogue_ser::RouteSettin
 */
 void Serializator::DeserializeRouterInfo(transport_catalogue_ser::RouterInfo& data) {
     std::vector<EdgeInfo> edges;
+    edges.reserve(data.edges_size());
 
     for (int i = 0; i < data.edges_size(); ++i) {
         transport_catalogue_ser::EdgeInfo* edge = data.mutable_edges(i);
         
         edges.emplace_back(
-            edge->weight(),
-            (edge->type() == 1 ? ids_to_routes_[edge->name_id()] : ids_to_stops_[edge->name_id()]),
-            edge->span_count(),
-            (edge->type() == 1 ? EdgeType::BUS : EdgeType::STOP)
+            edge->name_id(),
+            static_cast<uint16_t>(edge->span_count()),
+            static_cast<EdgeType>(edge->type() - 1),
+            edge->distance()
         );
     }
 
@@ -418,23 +579,162 @@ void Serializator::DeserializeGraphInfo(transport_catalogue_ser::Graph& data) {
         });
     }
 
-    std::vector<std::vector<graph::EdgeId>> incidence_lists;
-    incidence_lists.reserve(data.incidence_lists_size());
-
-    for (int i = 0; i < data.incidence_lists_size(); ++i) {
-        transport_catalogue_ser::Incidence* inc = data.mutable_incidence_lists(i);
+    std::vector<size_t> incidence_offsets(
+        data.incidence_offsets().begin(), data.incidence_offsets().end());
+    std::vector<graph::EdgeId> incidence_edges(
+        data.incidence_edges().begin(), data.incidence_edges().end());
 
-        std::vector<graph::EdgeId> list;
-        list.reserve(inc->incidence_size());
-        
-        for (int j = 0; j < inc->incidence_size(); ++j) {
-            list.push_back(inc->incidence(j));
+    router_.SetGraphAndRouter({
+        std::move(edges), std::move(incidence_offsets), std::move(incidence_edges) });
+}
+/**
+ * Десериализует таблицу маршрутов между всеми парами вершин
+*/
+void Serializator::DeserializeRoutesTable(transport_catalogue_ser::RoutesTable& data) {
+    const size_t vertex_count = data.vertex_count();
+    const size_t cells_count = vertex_count * vertex_count;
+    // Если таблица не была сохранена, либо повреждена - маршрутизатор рассчитает её заново
+    if (vertex_count == 0
+        || static_cast<size_t>(data.weights_size()) != cells_count
+        || static_cast<size_t>(data.prev_edges_size()) != cells_count) {
+        return;
+    }
+    using Router = graph::Router<double>;
+
+    TransportRouter::RoutesTable routes_table{
+        vertex_count,
+        std::vector<Router::TableWeight>(cells_count, Router::INFINITE_WEIGHT),
+        std::vector<Router::PrevEdgeId>(cells_count, Router::NO_EDGE)
+    };
+
+    for (size_t pos = 0; pos < cells_count; ++pos) {
+        const uint64_t prev_edge = data.prev_edges(pos);
+        if (prev_edge == 0) {
+            continue;
+        }
+        routes_table.weights[pos] = data.weights(pos);
+        if (prev_edge > 1) {
+            routes_table.prev_edges[pos] = static_cast<Router::PrevEdgeId>(prev_edge - 2);
         }
+    }
+
+    router_.SetRoutesTable(std::move(routes_table));
+}
+/**
+ * Десериализует сжатую таблицу последних ребер маршрутов между всеми парами вершин.
+ * Соответствие таблицы орграфу проверяется при создании маршрутизатора
+*/
+void Serializator::DeserializeCompactRoutesTable(transport_catalogue_ser::CompactRoutesTable& data) {
+    // Если таблица не была сохранена - маршрутизатор рассчитает её заново
+    if (data.vertex_count() == 0) {
+        return;
+    }
+
+    const std::string& cells = data.cells();
+    router_.SetCompactRoutesTable({
+        data.vertex_count(),
+        data.cell_size(),
+        std::vector<uint8_t>(cells.begin(), cells.end())
+    });
+    data.clear_cells();
+}
+/**
+ * Десериализует иерархию сжатий графа
+*/
+void Serializator::DeserializeContractionHierarchy(transport_catalogue_ser::ContractionHierarchy& data) {
+    // Если иерархия не была сохранена - маршрутизатор построит её заново
+    if (data.ranks_size() == 0) {
+        return;
+    }
+
+    TransportRouter::ContractionData contraction_data;
+    contraction_data.ranks.assign(data.ranks().begin(), data.ranks().end());
+    contraction_data.shortcuts.reserve(data.shortcuts_size());
+
+    for (const auto& shortcut : data.shortcuts()) {
+        contraction_data.shortcuts.push_back({
+            shortcut.from(),
+            shortcut.to(),
+            shortcut.weight(),
+            shortcut.first_edge(),
+            shortcut.second_edge()
+        });
+    }
 
-        incidence_lists.push_back(list);
+    router_.SetContractionData(std::move(contraction_data));
+}
+/**
+ * Десериализует ориентиры ALT и веса путей до них
+*/
+void Serializator::DeserializeLandmarks(transport_catalogue_ser::Landmarks& data) {
+    // Если ориентиры не были сохранены - маршрутизатор рассчитает их заново
+    if (data.landmarks_size() == 0) {
+        return;
     }
 
-    router_.SetGraphAndRouter({ edges, incidence_lists });
+    TransportRouter::LandmarkData landmark_data;
+    landmark_data.landmarks.assign(data.landmarks().begin(), data.landmarks().end());
+    landmark_data.from_landmarks.assign(data.from_landmarks().begin(), data.from_landmarks().end());
+    landmark_data.to_landmarks.assign(data.to_landmarks().begin(), data.to_landmarks().end());
+
+    router_.SetLandmarkData(std::move(landmark_data));
+}
+/**
+ * Десериализует разбиение орграфа на ячейки и клики ячеек
+*/
+void Serializator::DeserializeMultilevelPartition(transport_catalogue_ser::MultilevelPartition& data) {
+    // Если разбиение не было сохранено - маршрутизатор рассчитает его заново
+    if (data.levels_size() == 0) {
+        return;
+    }
+
+    TransportRouter::MultilevelData multilevel_data;
+    for (const auto& level : data.levels()) {
+        multilevel_data.levels.push_back({
+            std::vector<uint32_t>(level.cells().begin(), level.cells().end()),
+            std::vector<double>(level.clique_weights().begin(), level.clique_weights().end())
+        });
+    }
+
+    router_.SetMultilevelData(std::move(multilevel_data));
+}
+/**
+ * Десериализует метки индекса хабов
+*/
+void Serializator::DeserializeHubLabels(transport_catalogue_ser::HubLabels& data) {
+    // Если индекс не был сохранен - маршрутизатор рассчитает его заново при необходимости
+    if (data.order_size() == 0) {
+        return;
+    }
+
+    const auto deserialize_labels = [](const transport_catalogue_ser::HubLabelsSet& labels_data) {
+        graph::HubLabels<double>::Labels labels;
+        labels.offsets.assign(labels_data.offsets().begin(), labels_data.offsets().end());
+        labels.hubs.assign(labels_data.hubs().begin(), labels_data.hubs().end());
+        labels.weights.assign(labels_data.weights().begin(), labels_data.weights().end());
+        return labels;
+    };
+
+    TransportRouter::HubLabelsData hub_labels_data;
+    hub_labels_data.order.assign(data.order().begin(), data.order().end());
+    hub_labels_data.forward_labels = deserialize_labels(data.forward_labels());
+    hub_labels_data.backward_labels = deserialize_labels(data.backward_labels());
+
+    router_.SetHubLabelsData(std::move(hub_labels_data));
+}
+/**
+ * Десериализует компоненты связности орграфа
+*/
+void Serializator::DeserializeComponents(transport_catalogue_ser::Components& data) {
+    // Если компоненты не были сохранены - маршрутизатор рассчитает их заново
+    if (data.weak_components_size() == 0) {
+        return;
+    }
+
+    router_.SetComponentsData({
+        std::vector<uint32_t>(data.weak_components().begin(), data.weak_components().end()),
+        std::vector<uint32_t>(data.strong_components().begin(), data.strong_components().end())
+    });
 }
 
 } // namespace transport_catalogue
\ No newline at end of file
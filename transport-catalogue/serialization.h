@@ -44,9 +44,6 @@ private:
     std::unordered_map<std::string_view, int> stops_to_ids_; // Словарь остановки -> id
     std::unordered_map<int, std::string> ids_to_stops_; // Словарь id -> остановки
 
-    std::unordered_map<std::string_view, int> routes_to_ids_; // Словарь маршруты -> id
-    std::unordered_map<int, std::string> ids_to_routes_; // Словарь id -> маршруты
-
     void SaveStopsInfo(transport_catalogue_ser::TransportCatalogue* data);
     void SaveRoutesInfo(transport_catalogue_ser::TransportCatalogue* data);
     void SaveDistancesInfo(transport_catalogue_ser::TransportCatalogue* data);
@@ -64,10 +61,24 @@ private:
     void SaveRouterSettings(transport_catalogue_ser::RouteSettings* data);
     void SaveRouterInfo(transport_catalogue_ser::RouterInfo* data);
     void SaveGraphInfo(transport_catalogue_ser::Graph* data);
+    void SaveRoutesTable(transport_catalogue_ser::RoutesTable* data);
+    void SaveCompactRoutesTable(transport_catalogue_ser::CompactRoutesTable* data);
+    void SaveContractionHierarchy(transport_catalogue_ser::ContractionHierarchy* data);
+    void SaveLandmarks(transport_catalogue_ser::Landmarks* data);
+    void SaveMultilevelPartition(transport_catalogue_ser::MultilevelPartition* data);
+    void SaveComponents(transport_catalogue_ser::Components* data);
+    void SaveHubLabels(transport_catalogue_ser::HubLabels* data);
 
     void DeserializeRouteSettings(transport_catalogue_ser::RouteSettings& data);
     void DeserializeRouterInfo(transport_catalogue_ser::RouterInfo& data);
     void DeserializeGraphInfo(transport_catalogue_ser::Graph& data);
+    void DeserializeRoutesTable(transport_catalogue_ser::RoutesTable& data);
+    void DeserializeCompactRoutesTable(transport_catalogue_ser::CompactRoutesTable& data);
+    void DeserializeContractionHierarchy(transport_catalogue_ser::ContractionHierarchy& data);
+    void DeserializeLandmarks(transport_catalogue_ser::Landmarks& data);
+    void DeserializeMultilevelPartition(transport_catalogue_ser::MultilevelPartition& data);
+    void DeserializeComponents(transport_catalogue_ser::Components& data);
+    void DeserializeHubLabels(transport_catalogue_ser::HubLabels& data);
 };
 
 } // namespace transport_catalogue
\ No newline at end of file
@@ -0,0 +1,47 @@
+# Создает базу тестовой сети из шаблона BASE и сравнивает ответы process_requests на наборы
+# запросов с ожидаемыми. Параметры задаются через -D:
+#   TRANSPORT_CATALOGUE - исполняемый файл справочника, FIXTURE_DIR - каталог шаблонов,
+#   WORK_DIR - каталог базы и ответов теста, BASE - шаблон базы,
+#   REQUESTS - наборы запросов через запятую: набор name - шаблон requests_name.json.in
+#   и ответы expected_name.json,
+#   UPDATE - ON: база создается из шаблона base_partial.json.in и дополняется
+#   make_base --update маршрутами из update.json.in,
+#   остальные - подставляемые в шаблоны настройки маршрутизации и потоков
+file(MAKE_DIRECTORY "${WORK_DIR}")
+set(DATABASE "${WORK_DIR}/transport_catalogue.db")
+
+# Запускает справочник с аргументами ARGN на данных из шаблона template, вывод пишет в output
+function(run_transport_catalogue template output)
+    get_filename_component(input_name "${template}" NAME_WE)
+    set(input "${WORK_DIR}/${input_name}.json")
+    configure_file("${FIXTURE_DIR}/${template}" "${input}" @ONLY)
+    execute_process(
+        COMMAND "${TRANSPORT_CATALOGUE}" ${ARGN}
+        INPUT_FILE "${input}"
+        OUTPUT_FILE "${output}"
+        ERROR_VARIABLE errors
+        RESULT_VARIABLE result)
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "transport_catalogue ${ARGN} < ${input} failed (${result}): ${errors}")
+    endif()
+endfunction()
+
+if(UPDATE)
+    run_transport_catalogue(base_partial.json.in "${WORK_DIR}/make_base.out" make_base)
+    run_transport_catalogue(update.json.in "${WORK_DIR}/update.out" make_base --update)
+else()
+    run_transport_catalogue("${BASE}" "${WORK_DIR}/make_base.out" make_base)
+endif()
+
+string(REPLACE "," ";" request_sets "${REQUESTS}")
+foreach(request_set ${request_sets})
+    set(answers "${WORK_DIR}/answers_${request_set}.json")
+    set(expected "${FIXTURE_DIR}/expected_${request_set}.json")
+    run_transport_catalogue(requests_${request_set}.json.in "${answers}" process_requests)
+    execute_process(
+        COMMAND "${CMAKE_COMMAND}" -E compare_files "${answers}" "${expected}"
+        RESULT_VARIABLE result)
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "Answers ${answers} differ from ${expected}")
+    endif()
+endforeach()
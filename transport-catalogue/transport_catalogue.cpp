@@ -151,6 +151,12 @@ const std::unordered_map<std::string_view, domain::Stop*>& TransportCatalogue::G
 const deque<domain::Stop>& TransportCatalogue::GetStops() const {
 	return stops_;
 }
+/**
+ * Возвращает константную ссылку на дэк всех маршрутов в порядке добавления
+*/
+const deque<domain::Route>& TransportCatalogue::GetRoutes() const {
+	return routes_;
+}
 /**
  * Возвращает константную ссылку на словарь, где:
  * ключ - наименование остановки;
@@ -40,6 +40,7 @@ public:
 	const std::unordered_map<std::string_view, domain::Route*>& GetRoutesMap() const;
 	const std::unordered_map<std::string_view, domain::Stop*>& GetStopsMap() const;
 	const std::deque<domain::Stop>& GetStops() const;
+	const std::deque<domain::Route>& GetRoutes() const;
 	const std::unordered_map<std::string_view, std::set<std::string_view>>& GetStopsToRoutes() const;
 	const std::unordered_map<std::pair<domain::Stop*, domain::Stop*>, 
 		double, StopsPairHasher>& GetStopsToDistances() const;
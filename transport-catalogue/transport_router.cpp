@@ -1,8 +1,12 @@
 #include "transport_router.h"
 
+#include <algorithm>
 #include <cmath>
 #include <functional>
+#include <limits>
+#include <stdexcept>
 #include <string_view>
+#include <type_traits>
 #include <unordered_map>
 #include <utility>
 
@@ -22,7 +26,75 @@ TransportRouter::TransportRouter(TransportCatalogue& transport_catalogue)
  * Задает конфигурацию автобусов в маршрутизаторе
 */
 void TransportRouter::SetRouteSettings(RouteSettings route_settings) {
+    const bool is_cache_resized = route_settings.route_cache_size != route_settings_.route_cache_size;
     route_settings_ = std::move(route_settings);
+    // Смена емкости сбрасывает кэш вместе со счетчиками попаданий и промахов
+    if (is_cache_resized) {
+        route_cache_.SetCapacity(route_settings_.route_cache_size);
+    }
+}
+/**
+ * Применяет новые настройки, пересчитывая только то, что от них зависит.
+ * При смене ожидания, скорости или округления весов веса ребер орграфа пересчитываются
+ * за один проход по ребрам без перестройки орграфа, а движок маршрутизации создается заново,
+ * так что предварительный расчет all_pairs, compact_all_pairs, contraction_hierarchy и alt
+ * выполняется повторно. У движка multilevel_dijkstra разбиение орграфа сохраняется,
+ * пересчитываются только клики ячеек. При смене типа движка или числа ориентиров alt
+ * движок создается заново по прежним весам, а размер кэша и число потоков просто запоминаются.
+ * Модель орграфа меняет его топологию, поэтому изменить её нельзя.
+ * Нельзя вызывать конкурентно с запросами маршрутов
+*/
+void TransportRouter::Customize(RouteSettings route_settings) {
+    EnsureRouterInitialized();
+    if (route_settings.graph_model != route_settings_.graph_model) {
+        throw std::invalid_argument("Graph model can't be changed without rebuilding the graph");
+    }
+
+    const bool is_reweighted = route_settings.wait_time != route_settings_.wait_time
+        || route_settings.velocity != route_settings_.velocity
+        || route_settings.integer_weights != route_settings_.integer_weights;
+    const bool is_router_type_changed = route_settings.router_type != route_settings_.router_type;
+    const bool is_router_changed = is_reweighted || is_router_type_changed
+        || (route_settings.router_type == RouterType::ALT
+            && route_settings.landmark_count != route_settings_.landmark_count);
+    const bool is_hub_labels_changed = route_settings.hub_labels != route_settings_.hub_labels;
+    SetRouteSettings(std::move(route_settings));
+
+    if (is_reweighted) {
+        for (graph::EdgeId edge_id = 0; edge_id < edges_.size(); ++edge_id) {
+            orgraph_.SetEdgeWeight(edge_id, CountEdgeWeight(edges_[edge_id]));
+        }
+
+        // Предрасчитанные по прежним весам данные больше не действительны
+        routes_table_.reset();
+        compact_routes_table_.reset();
+        contraction_data_.reset();
+        landmark_data_.reset();
+        multilevel_data_.reset();
+        hub_labels_data_.reset();
+
+        // Время в пути по расписанию зависит от скорости - маршрутизатор по расписанию
+        // будет создан заново при следующем запросе
+        timetable_router_.reset();
+        timetable_stops_ids_.clear();
+        timetable_lines_routes_.clear();
+        is_timetable_initialized_.store(false, std::memory_order_release);
+    }
+
+    // Разбиение орграфа не зависит от весов - многоуровневому движку достаточно пересчитать клики
+    auto* multilevel_router = std::get_if<graph::MultilevelRouter<double>>(&router_);
+    if (is_reweighted && !is_router_type_changed && multilevel_router) {
+        multilevel_router->Customize(route_settings_.precompute_threads);
+        route_cache_.Clear();
+        one_to_many_router_.emplace(orgraph_);
+        EmplaceHubLabels();
+    }
+    else if (is_router_changed) {
+        EmplaceRouter();
+    }
+    else if (is_hub_labels_changed) {
+        EmplaceHubLabels();
+    }
 }
 /**
  * Задает вектор вершин
@@ -30,18 +102,78 @@ void TransportRouter::SetRouteSettings(RouteSettings route_settings) {
 void TransportRouter::SetEdges(const std::vector<EdgeInfo>& edges) {
     edges_ = edges;
 }
+/**
+ * Задает рассчитанную заранее таблицу маршрутов, которая будет использована
+ * при создании маршрутизатора ALL_PAIRS вместо повторного расчета
+*/
+void TransportRouter::SetRoutesTable(RoutesTable routes_table) {
+    routes_table_ = std::move(routes_table);
+}
+/**
+ * Задает рассчитанную заранее сжатую таблицу маршрутов, которая будет использована
+ * при создании маршрутизатора COMPACT_ALL_PAIRS вместо повторного расчета
+*/
+void TransportRouter::SetCompactRoutesTable(CompactRoutesTable compact_routes_table) {
+    compact_routes_table_ = std::move(compact_routes_table);
+}
+/**
+ * Задает рассчитанную заранее иерархию сжатий, которая будет использована
+ * при создании маршрутизатора CONTRACTION_HIERARCHY вместо повторного сжатия
+*/
+void TransportRouter::SetContractionData(ContractionData contraction_data) {
+    contraction_data_ = std::move(contraction_data);
+}
+/**
+ * Задает рассчитанные заранее ориентиры, которые будут использованы
+ * при создании маршрутизатора ALT вместо повторного расчета
+*/
+void TransportRouter::SetLandmarkData(LandmarkData landmark_data) {
+    landmark_data_ = std::move(landmark_data);
+}
+/**
+ * Задает рассчитанные заранее разбиение орграфа и клики ячеек, которые будут использованы
+ * при создании маршрутизатора MULTILEVEL_DIJKSTRA вместо повторного расчета
+*/
+void TransportRouter::SetMultilevelData(MultilevelData multilevel_data) {
+    multilevel_data_ = std::move(multilevel_data);
+}
+/**
+ * Задает рассчитанные заранее компоненты связности орграфа, которые будут использованы
+ * при создании индекса связности вместо повторного расчета
+*/
+void TransportRouter::SetComponentsData(ComponentsData components_data) {
+    components_data_ = std::move(components_data);
+}
+/**
+ * Задает рассчитанные заранее метки индекса хабов, которые будут использованы
+ * при его создании вместо повторного расчета
+*/
+void TransportRouter::SetHubLabelsData(HubLabelsData hub_labels_data) {
+    hub_labels_data_ = std::move(hub_labels_data);
+}
 /**
  * Задает орграф и маршрутизатор
 */
-void TransportRouter::SetGraphAndRouter(const graph::DirectedWeightedGraph<double>& orgraph) {
+void TransportRouter::SetGraphAndRouter(graph::DirectedWeightedGraph<double> orgraph) {
     // Если маршрутизатор уже задан - прекращаем инициилизацию
-    if (router_) {
+    if (IsRouterInitialized()) {
         return;
     }
     // Задаем десериализованный орграф
-    orgraph_ = orgraph;
+    orgraph_ = std::move(orgraph);
+    orgraph_.Freeze();
+
+    // Если компоненты связности были заданы заранее - не рассчитываем их повторно
+    if (components_data_) {
+        connectivity_.emplace(orgraph_.GetVertexCount(), std::move(*components_data_));
+        components_data_.reset();
+    }
+    else {
+        connectivity_.emplace(orgraph_);
+    }
 
     // Задаем вершины из десериализованных данных траснпортного справочника
+    graph_routes_count_ = transport_catalogue_.GetRoutes().size();
     size_t vertex_count = 0;
     for (const auto& stop : transport_catalogue_.GetStops()) {
         Vertex in = { stop.name, VertexType::IN, vertex_count++ };
@@ -51,15 +183,98 @@ void TransportRouter::SetGraphAndRouter(const graph::DirectedWeightedGraph<doubl
     }
 
     // Инициилизируем маршрутизатор
-    router_.emplace(orgraph_);
+    EmplaceRouter();
 }
 
+/**
+ * Добавляет в орграф ребра маршрутов, внесенных в справочник после создания орграфа.
+ * Маршруты должны проходить только через остановки, уже имеющие вершины в орграфе.
+ * Таблица маршрутов ALL_PAIRS обновляется релаксацией через новые и укороченные ребра
+ * без полного пересчета, данные остальных движков рассчитываются заново
+*/
+void TransportRouter::AddNewRoutes() {
+    const auto& routes = transport_catalogue_.GetRoutes();
+    // Если орграф еще не создан - маршруты войдут в него при создании
+    if (!IsRouterInitialized() || graph_routes_count_ == routes.size()) {
+        return;
+    }
+    if (transport_catalogue_.GetStops().size() != vertexes_.size()) {
+        throw std::logic_error("New stops can't be added to the existing graph");
+    }
+
+    // Запоминаем веса ребер: слияние параллельных ребер может укоротить уже существующие
+    std::vector<double> old_weights;
+    old_weights.reserve(orgraph_.GetEdgeCount());
+    for (const auto& edge : orgraph_.GetEdges()) {
+        old_weights.push_back(edge.weight);
+    }
+
+    orgraph_.Unfreeze();
+    if (route_settings_.graph_model == GraphModel::LINEAR) {
+        // Вершины поездки новых маршрутов следуют за всеми существующими вершинами
+        graph::VertexId ride_vertex = orgraph_.GetVertexCount();
+        orgraph_.AddVertexes(CountRideVertexes(graph_routes_count_));
+        for (size_t route_id = graph_routes_count_; route_id < routes.size(); ++route_id) {
+            ride_vertex = AddRideChainEdges(orgraph_, static_cast<uint32_t>(route_id), ride_vertex);
+        }
+    }
+    else {
+        PairsToEdges pairs_to_edges;
+        for (graph::EdgeId edge_id = 0; edge_id < edges_.size(); ++edge_id) {
+            if (edges_[edge_id].type == EdgeType::BUS) {
+                const auto& edge = orgraph_.GetEdge(edge_id);
+                pairs_to_edges.emplace(std::pair{ edge.from, edge.to }, edge_id);
+            }
+        }
+        for (size_t route_id = graph_routes_count_; route_id < routes.size(); ++route_id) {
+            AddRouteSpanEdges(orgraph_, static_cast<uint32_t>(route_id), pairs_to_edges);
+        }
+    }
+    orgraph_.Freeze();
+    graph_routes_count_ = routes.size();
+    connectivity_.emplace(orgraph_);
+
+    if (auto* router = std::get_if<graph::Router<double>>(&router_)) {
+        std::vector<graph::EdgeId> updated_edges;
+        for (graph::EdgeId edge_id = 0; edge_id < orgraph_.GetEdgeCount(); ++edge_id) {
+            if (edge_id >= old_weights.size() || orgraph_.GetEdge(edge_id).weight < old_weights[edge_id]) {
+                updated_edges.push_back(edge_id);
+            }
+        }
+        router->UpdateEdges(updated_edges);
+        route_cache_.Clear();
+        one_to_many_router_.emplace(orgraph_);
+        EmplaceHubLabels();
+    }
+    else {
+        EmplaceRouter();
+    }
+
+    // Новые маршруты могут иметь расписание - маршрутизатор по расписанию
+    // будет создан заново при следующем запросе
+    timetable_router_.reset();
+    timetable_stops_ids_.clear();
+    timetable_lines_routes_.clear();
+    is_timetable_initialized_.store(false, std::memory_order_release);
+}
 /**
  * Возвращает константную ссылку на структуру настроен маршрутизатора
 */
 const RouteSettings& TransportRouter::GetRouteSettings() const {
     return route_settings_;
 }
+/**
+ * Возвращает название остановки по её индексу в справочнике
+*/
+std::string_view TransportRouter::GetStopName(uint32_t stop_id) const {
+    return transport_catalogue_.GetStops().at(stop_id).name;
+}
+/**
+ * Возвращает номер маршрута по его индексу в справочнике
+*/
+std::string_view TransportRouter::GetRouteName(uint32_t route_id) const {
+    return transport_catalogue_.GetRoutes().at(route_id).number;
+}
 /**
  * Возвращает константную ссылку на массив всех ребер
 */
@@ -72,98 +287,559 @@ const std::vector<EdgeInfo>& TransportRouter::GetEdges() const {
 const graph::DirectedWeightedGraph<double>& TransportRouter::GetGraph() const {
     return orgraph_;
 }
+/**
+ * Возвращает указатель на таблицу маршрутов между всеми парами вершин,
+ * либо nullptr, если выбранный движок маршрутизации её не рассчитывает
+*/
+const TransportRouter::RoutesTable* TransportRouter::GetRoutesTable() const {
+    if (const auto* router = std::get_if<graph::Router<double>>(&router_)) {
+        return &router->GetRoutesInternalData();
+    }
+    return nullptr;
+}
+/**
+ * Возвращает указатель на сжатую таблицу маршрутов между всеми парами вершин,
+ * либо nullptr, если выбранный движок маршрутизации её не рассчитывает
+*/
+const TransportRouter::CompactRoutesTable* TransportRouter::GetCompactRoutesTable() const {
+    if (const auto* router = std::get_if<graph::CompactRouter<double>>(&router_)) {
+        return &router->GetCompactRoutesData();
+    }
+    return nullptr;
+}
+/**
+ * Возвращает указатель на данные иерархии сжатий,
+ * либо nullptr, если выбранный движок маршрутизации её не строит
+*/
+const TransportRouter::ContractionData* TransportRouter::GetContractionData() const {
+    if (const auto* router = std::get_if<graph::ContractionHierarchyRouter<double>>(&router_)) {
+        return &router->GetContractionData();
+    }
+    return nullptr;
+}
+/**
+ * Возвращает указатель на ориентиры ALT, либо nullptr, если выбранный движок их не рассчитывает
+*/
+const TransportRouter::LandmarkData* TransportRouter::GetLandmarkData() const {
+    if (const auto* router = std::get_if<graph::LandmarkRouter<double>>(&router_)) {
+        return &router->GetLandmarkData();
+    }
+    return nullptr;
+}
+/**
+ * Возвращает указатель на разбиение орграфа и клики ячеек,
+ * либо nullptr, если выбранный движок их не рассчитывает
+*/
+const TransportRouter::MultilevelData* TransportRouter::GetMultilevelData() const {
+    if (const auto* router = std::get_if<graph::MultilevelRouter<double>>(&router_)) {
+        return &router->GetMultilevelData();
+    }
+    return nullptr;
+}
+
+/**
+ * Возвращает указатель на компоненты связности орграфа, либо nullptr, если орграф не создан
+*/
+const TransportRouter::ComponentsData* TransportRouter::GetComponentsData() const {
+    return connectivity_ ? &connectivity_->GetComponentsData() : nullptr;
+}
+/**
+ * Возвращает указатель на метки индекса хабов, либо nullptr, если индекс не строится
+*/
+const TransportRouter::HubLabelsData* TransportRouter::GetHubLabelsData() const {
+    return hub_labels_ ? &hub_labels_->GetLabelsData() : nullptr;
+}
+
+/**
+ * Возвращает число запросов маршрута, ответ на которые найден в кэше
+*/
+size_t TransportRouter::GetRouteCacheHits() const {
+    return route_cache_.GetHits();
+}
+/**
+ * Возвращает число запросов маршрута, ответ на которые не найден в кэше
+*/
+size_t TransportRouter::GetRouteCacheMisses() const {
+    return route_cache_.GetMisses();
+}
 
 /**
- * Возвращает общую информацию о построенном маршруте
+ * Возвращает общую информацию о построенном маршруте, либо nullptr, если маршрут не найден.
+ * Маршрут с неизвестной остановкой или между несвязанными частями сети не ищется
 */
-std::optional<RouteResult> TransportRouter::BuildRoute(std::string_view from, std::string_view to) {
+std::shared_ptr<const RouteResult> TransportRouter::BuildRoute(std::string_view from, std::string_view to) {
     // Если маршрутизатор орграфа не инициилизирован - инициилизируем
-    if (!router_) {
-        InitializeGraphRouter();
+    EnsureRouterInitialized();
+
+    const auto stop_vertex_from = FindStopVertex(from);
+    const auto stop_vertex_to = FindStopVertex(to);
+    if (!stop_vertex_from || !stop_vertex_to
+        || !connectivity_->MayReach(*stop_vertex_from, *stop_vertex_to)) {
+        return nullptr;
+    }
+    const graph::VertexId vertex_from = *stop_vertex_from;
+    const graph::VertexId vertex_to = *stop_vertex_to;
+
+    // Если маршрут уже строился - возвращаем сохраненный результат
+    const bool is_cache_enabled = route_settings_.route_cache_size > 0;
+    if (is_cache_enabled) {
+        if (auto cached = route_cache_.Get({ vertex_from, vertex_to })) {
+            return *cached;
+        }
     }
 
-    // Получаем результат построения машрута
-    const auto result_route = router_.value().BuildRoute(
-        vertexes_.at(from).in.id, vertexes_.at(to).in.id
-    );
+    // Получаем результат построения машрута выбранным движком
+    graph::DijkstraRouter<double>::SearchStats stats;
+    const auto result_route = std::visit([this, vertex_from, vertex_to, &stats](const auto& router) {
+        using RouterT = std::decay_t<decltype(router)>;
+        if constexpr (std::is_same_v<RouterT, std::monostate>) {
+            return std::optional<graph::Router<double>::RouteInfo>{};
+        }
+        else if constexpr (std::is_same_v<RouterT, graph::DijkstraRouter<double>>) {
+            if (route_settings_.router_type != RouterType::A_STAR) {
+                return router.BuildRoute(vertex_from, vertex_to, &stats);
+            }
+            // Нижняя оценка времени пути до цели - время поездки по прямой с наибольшей скоростью
+            const geo::Coordinates& target = vertexes_coordinates_[vertex_to];
+            const auto potential = [this, &target](graph::VertexId vertex) {
+                const double distance = geo::ComputeDistance(vertexes_coordinates_[vertex], target);
+                return std::isnan(distance) ? 0.0 : distance * min_minutes_per_meter_;
+            };
+            return router.BuildRouteWithPotential(vertex_from, vertex_to, potential, &stats);
+        }
+        else if constexpr (std::is_same_v<RouterT, graph::DijkstraRouter<uint64_t>>) {
+            // Вес маршрута - точная сумма целых десятых долей секунды
+            graph::DijkstraRouter<uint64_t>::SearchStats integer_stats;
+            auto route = router.BuildRoute(vertex_from, vertex_to, &integer_stats);
+            stats.settled_vertices = integer_stats.settled_vertices;
+            if (!route) {
+                return std::optional<graph::Router<double>::RouteInfo>{};
+            }
+            return std::optional<graph::Router<double>::RouteInfo>{ graph::Router<double>::RouteInfo{
+                static_cast<double>(route->weight) / DECISECONDS_PER_MINUTE, std::move(route->edges) } };
+        }
+        else if constexpr (std::is_same_v<RouterT, graph::BidirectionalDijkstraRouter<double>>
+            || std::is_same_v<RouterT, graph::LandmarkRouter<double>>
+            || std::is_same_v<RouterT, graph::MultilevelRouter<double>>) {
+            return router.BuildRoute(vertex_from, vertex_to, &stats);
+        }
+        else {
+            return router.BuildRoute(vertex_from, vertex_to);
+        }
+    }, router_);
 
-    // Если маршрут не наден - возвращаем nullopt
+    // Если маршрут не наден - возвращаем nullptr
     if (!result_route) {
+        if (is_cache_enabled) {
+            route_cache_.Put({ vertex_from, vertex_to }, nullptr);
+        }
+        return nullptr;
+    }
+
+    auto result = MakeRouteResult(result_route.value(), stats.settled_vertices);
+    if (is_cache_enabled) {
+        route_cache_.Put({ vertex_from, vertex_to }, result);
+    }
+    return result;
+}
+/**
+ * Возвращает маршруты от остановки from до каждой из остановок to в том же порядке,
+ * nullptr - маршрут не найден. Все маршруты берутся из одного дерева кратчайших путей
+*/
+std::vector<std::shared_ptr<const RouteResult>> TransportRouter::BuildRoutes(std::string_view from,
+    const std::vector<std::string_view>& to) {
+    // Если маршрутизатор орграфа не инициилизирован - инициилизируем
+    EnsureRouterInitialized();
+
+    std::vector<std::shared_ptr<const RouteResult>> results;
+    results.reserve(to.size());
+
+    // Таблица маршрутов между всеми парами уже содержит ответы - поиск не нужен
+    if (std::holds_alternative<graph::Router<double>>(router_)
+        || std::holds_alternative<graph::CompactRouter<double>>(router_)) {
+        for (const std::string_view stop_to : to) {
+            results.push_back(BuildRoute(from, stop_to));
+        }
+        return results;
+    }
+
+    // Пути ищутся только до остановок, которые могут быть достижимы по индексу связности:
+    // иначе поиск не остановится, пока не просмотрит всю свою часть сети
+    const auto vertex_from = FindStopVertex(from);
+    std::vector<graph::VertexId> vertexes_to;
+    std::vector<size_t> targets_positions;
+    for (size_t pos = 0; pos < to.size(); ++pos) {
+        const auto vertex_to = FindStopVertex(to[pos]);
+        if (vertex_from && vertex_to && connectivity_->MayReach(*vertex_from, *vertex_to)) {
+            vertexes_to.push_back(*vertex_to);
+            targets_positions.push_back(pos);
+        }
+    }
+
+    results.resize(to.size(), nullptr);
+    if (vertexes_to.empty()) {
+        return results;
+    }
+
+    // Дерево кратчайших путей строится по орграфу независимо от выбранного движка
+    graph::DijkstraRouter<double>::SearchStats stats;
+    const auto routes = one_to_many_router_->BuildRoutes(*vertex_from, vertexes_to, &stats);
+    for (size_t i = 0; i < routes.size(); ++i) {
+        if (routes[i]) {
+            results[targets_positions[i]] = MakeRouteResult(*routes[i], stats.settled_vertices);
+        }
+    }
+    return results;
+}
+/**
+ * Возвращает время маршрута от остановки from до остановки to без построения самого маршрута,
+ * либо nullopt, если маршрут не найден. При построенном индексе хабов поиск не ведется
+*/
+std::optional<double> TransportRouter::ComputeRouteTime(std::string_view from, std::string_view to) {
+    EnsureRouterInitialized();
+
+    if (hub_labels_) {
+        const auto vertex_from = FindStopVertex(from);
+        const auto vertex_to = FindStopVertex(to);
+        if (!vertex_from || !vertex_to || !connectivity_->MayReach(*vertex_from, *vertex_to)) {
+            return std::nullopt;
+        }
+        return hub_labels_->GetWeight(*vertex_from, *vertex_to);
+    }
+
+    const auto route = BuildRoute(from, to);
+    if (!route) {
+        return std::nullopt;
+    }
+    return route->time;
+}
+/**
+ * Возвращает времена маршрутов от остановки from до каждой из остановок to в том же порядке,
+ * nullopt - маршрут не найден
+*/
+std::vector<std::optional<double>> TransportRouter::ComputeRouteTimes(std::string_view from,
+    const std::vector<std::string_view>& to) {
+    EnsureRouterInitialized();
+
+    std::vector<std::optional<double>> times;
+    times.reserve(to.size());
+    if (hub_labels_) {
+        for (const std::string_view stop_to : to) {
+            times.push_back(ComputeRouteTime(from, stop_to));
+        }
+        return times;
+    }
+
+    for (const auto& route : BuildRoutes(from, to)) {
+        times.push_back(route ? std::optional<double>(route->time) : std::nullopt);
+    }
+    return times;
+}
+
+/**
+ * Возвращает остановки, до которых из from можно доехать не более чем за max_time минут,
+ * с временем маршрута до них в порядке его неубывания, либо nullopt, если остановка неизвестна
+*/
+std::optional<IsochroneResult> TransportRouter::BuildIsochrone(std::string_view from, double max_time) {
+    // Если маршрутизатор орграфа не инициилизирован - инициилизируем
+    EnsureRouterInitialized();
+
+    const auto vertex_from = FindStopVertex(from);
+    if (!vertex_from) {
+        return std::nullopt;
+    }
+
+    graph::DijkstraRouter<double>::SearchStats stats;
+    const auto reachable = one_to_many_router_->BuildReachable(*vertex_from, max_time, &stats);
+
+    // Вершина входа остановки с индексом i в справочнике имеет id 2 * i,
+    // вершины выхода и вершины поездки в ответ не входят
+    const auto& stops = transport_catalogue_.GetStops();
+    IsochroneResult result{ {}, stats.settled_vertices };
+    for (const auto& [vertex, time] : reachable) {
+        if (vertex % 2 == 0 && vertex / 2 < stops.size()) {
+            result.stops.emplace_back(stops[vertex / 2].name, time);
+        }
+    }
+    return result;
+}
+
+/**
+ * Возвращает маршрут по расписанию с самым ранним прибытием в to при отправлении из from
+ * не раньше departure_time и не более чем max_transfers пересадках, либо nullopt,
+ * если маршрут не найден или остановка неизвестна
+*/
+std::optional<JourneyResult> TransportRouter::BuildJourney(std::string_view from, std::string_view to,
+    double departure_time, size_t max_transfers) {
+    // Если маршрутизатор по расписанию не создан - создаем
+    EnsureTimetableInitialized();
+
+    const auto from_it = timetable_stops_ids_.find(from);
+    const auto to_it = timetable_stops_ids_.find(to);
+    if (from_it == timetable_stops_ids_.end() || to_it == timetable_stops_ids_.end()) {
+        return std::nullopt;
+    }
+
+    const auto journey = timetable_router_->BuildJourney(
+        from_it->second, to_it->second, departure_time, max_transfers);
+    if (!journey) {
+        return std::nullopt;
+    }
+
+    // Каждой поездке предшествует ожидание рейса на остановке посадки
+    JourneyResult result{ departure_time, journey->arrival, {} };
+    double ready_time = departure_time;
+    for (const auto& leg : journey->legs) {
+        const auto& line = timetable_router_->GetLine(leg.line);
+
+        result.items.push_back({ leg.departure - ready_time,
+            static_cast<uint32_t>(line.stops[leg.board_pos]), 0, EdgeType::STOP });
+        result.items.push_back({ leg.arrival - leg.departure,
+            timetable_lines_routes_[leg.line], ToSpanCount(leg.alight_pos - leg.board_pos), EdgeType::BUS });
+
+        ready_time = leg.arrival;
+    }
+
+    return result;
+}
+
+/**
+ * Возвращает id входной вершины остановки, либо nullopt, если остановка неизвестна
+*/
+std::optional<graph::VertexId> TransportRouter::FindStopVertex(std::string_view stop) const {
+    const auto it = vertexes_.find(stop);
+    if (it == vertexes_.end()) {
         return std::nullopt;
     }
+    return it->second.in.id;
+}
+/**
+ * Формирует информацию о маршруте по ребрам орграфа
+*/
+std::shared_ptr<const RouteResult> TransportRouter::MakeRouteResult(
+    const graph::Router<double>::RouteInfo& route, size_t settled_vertices) const {
+    // Итерируемся по id ребер, вставляем в контейнер items элементы маршрута
+    std::vector<RouteItem> items;
+    for (const auto& edge_id : route.edges) {
+        const EdgeInfo& edge = edges_.at(edge_id);
+        const double weight = orgraph_.GetEdge(edge_id).weight;
 
-    // // Итерируемся по id ребер, вставляем в контейнер final_edges информацию о ребрах маршрута
-    std::vector<EdgeInfo> final_edges;
-    for (const auto& edge_id : result_route.value().edges) {
-        final_edges.push_back(edges_.at(edge_id));
+        // Посадку, перегоны и высадку модели LINEAR сворачиваем в одну поездку
+        switch (edge.type) {
+        case EdgeType::BOARDING:
+            items.push_back({ 0.0, edge.name_id, 0, EdgeType::BUS });
+            break;
+        case EdgeType::RIDE:
+            items.back().time += weight;
+            ++items.back().span_count;
+            break;
+        case EdgeType::ALIGHTING:
+            break;
+        default:
+            items.push_back({ weight, edge.name_id, edge.span_count, edge.type });
+            break;
+        }
     }
 
-    return RouteResult{ 
-        result_route.value().weight,
-        final_edges 
-    };
+    return std::make_shared<const RouteResult>(RouteResult{ 
+        route.weight,
+        std::move(items),
+        settled_vertices
+    });
 }
 
 /**
  * Возвращает орграф, созданный на основе данных из транспортного справочника
 */
 graph::DirectedWeightedGraph<double> TransportRouter::GetFilledOrgraph() {
+    const bool is_linear = route_settings_.graph_model == GraphModel::LINEAR;
+
     // Создадим проинициилизированный орграф
-    graph::DirectedWeightedGraph<double> orgraph = CreateVertexesAndOrgraph();
+    graph::DirectedWeightedGraph<double> orgraph
+        = CreateVertexesAndOrgraph(is_linear ? CountRideVertexes() : 0);
+
+    if (is_linear) {
+        AddRideChainEdges(orgraph);
+    }
+    else {
+        AddRouteSpanEdges(orgraph);
+    }
+    graph_routes_count_ = transport_catalogue_.GetRoutes().size();
+
+    return orgraph;
+}
+/**
+ * Возвращает копию orgraph_ с весами ребер в целых десятых долях секунды.
+ * Веса orgraph_ при integer_weights уже кратны десятой доле секунды
+*/
+graph::DirectedWeightedGraph<uint64_t> TransportRouter::GetIntegerOrgraph() const {
+    graph::DirectedWeightedGraph<uint64_t> orgraph(orgraph_.GetVertexCount());
+    for (const auto& edge : orgraph_.GetEdges()) {
+        orgraph.AddEdge({ edge.from, edge.to,
+            static_cast<uint64_t>(std::llround(edge.weight * DECISECONDS_PER_MINUTE)) });
+    }
+    orgraph.Freeze();
+    return orgraph;
+}
+/**
+ * Добавляет в орграф ребра от каждой остановки маршрута до каждой последующей.
+ * Параллельные ребра между одной парой остановок, которые дают разные маршруты,
+ * сливаются в одно ребро с наименьшим расстоянием: маршрутизатор все равно выбрал бы его.
+ * Информация о ребре сохраняет маршрут и число перегонов выбранного ребра,
+ * при равных расстояниях - ребра, добавленного первым
+*/
+void TransportRouter::AddRouteSpanEdges(graph::DirectedWeightedGraph<double>& orgraph) {
+    // Id ребра, уже добавленного между парой вершин
+    PairsToEdges pairs_to_edges;
 
+    // Итерируемся по маршрутам, индекс маршрута в справочнике - его id в информации о ребрах
+    const auto& routes = transport_catalogue_.GetRoutes();
+    for (uint32_t route_id = 0; route_id < routes.size(); ++route_id) {
+        AddRouteSpanEdges(orgraph, route_id, pairs_to_edges);
+    }
+}
+/**
+ * Добавляет в орграф ребра маршрута route_id от каждой его остановки до каждой последующей,
+ * pairs_to_edges - id ребер, уже добавленных между парами вершин
+*/
+void TransportRouter::AddRouteSpanEdges(graph::DirectedWeightedGraph<double>& orgraph, uint32_t route_id,
+    PairsToEdges& pairs_to_edges) {
     // Получаем ссылку на словарь с парами остановок и расстояниями между ними
     const auto& stops_pairs_to_distances = transport_catalogue_.GetStopsToDistances();
 
-    // Итерируемся по маршрутам
-    for (const auto& [name, route_struct] : transport_catalogue_.GetRoutesMap()) {
-        // Итерируемся по остановкам маршрута до предпоследней остановки
-        for (auto it = route_struct->stops.begin();
-            it != prev(route_struct->stops.end()); 
-            ++it) {
-            // Инициилизируем предшествующие расстояния
-            double distance = 0.0;
-
-            // Итерируемся по оставшимся остановкам маршрута
-            for (auto sub_it = it + 1; sub_it != route_struct->stops.end(); ++sub_it) {
-                // Ограничиваем добавление ребер для некольцевых маршрутов
-                if (!route_struct->is_round
-                    && (sub_it - route_struct->stops.begin()) 
-                        == std::ceil(route_struct->stops.size() / 2) + 1
-                    && *prev(sub_it) == *(route_struct->stops.begin() + route_struct->stops.size() / 2)
-                    && (it - route_struct->stops.begin())
-                        != std::ceil(route_struct->stops.size() / 2)) {
-                    break;
+    const domain::Route* route_struct = &transport_catalogue_.GetRoutes()[route_id];
+    // Если у маршрута нет остановок - ребер нет
+    if (route_struct->stops.empty()) {
+        return;
+    }
+    // Итерируемся по остановкам маршрута до предпоследней остановки
+    for (auto it = route_struct->stops.begin();
+        it != prev(route_struct->stops.end()); 
+        ++it) {
+        // Инициилизируем предшествующие расстояния
+        double distance = 0.0;
+
+        // Итерируемся по оставшимся остановкам маршрута
+        for (auto sub_it = it + 1; sub_it != route_struct->stops.end(); ++sub_it) {
+            // Ограничиваем добавление ребер для некольцевых маршрутов
+            if (!route_struct->is_round
+                && (sub_it - route_struct->stops.begin()) 
+                    == std::ceil(route_struct->stops.size() / 2) + 1
+                && *prev(sub_it) == *(route_struct->stops.begin() + route_struct->stops.size() / 2)
+                && (it - route_struct->stops.begin())
+                    != std::ceil(route_struct->stops.size() / 2)) {
+                break;
+            }
+
+            // Находим расстояние между парой остановок
+            distance += stops_pairs_to_distances.at({ *(sub_it - 1), *sub_it });
+
+            const graph::VertexId from = vertexes_.at((*it)->name).out.id;
+            const graph::VertexId to = vertexes_.at((*sub_it)->name).in.id;
+            const EdgeInfo edge_info{
+                route_id,
+                ToSpanCount(static_cast<size_t>(std::distance(it, sub_it))),
+                EdgeType::BUS,
+                distance
+            };
+
+            // Если между вершинами уже есть ребро - оставляем более короткое
+            const auto [pair_it, is_new_pair] = pairs_to_edges.emplace(std::pair{ from, to }, edges_.size());
+            if (!is_new_pair) {
+                const graph::EdgeId edge_id = pair_it->second;
+                if (distance < edges_[edge_id].distance) {
+                    edges_[edge_id] = edge_info;
+                    orgraph.SetEdgeWeight(edge_id, CountEdgeWeight(edge_info));
                 }
+                continue;
+            }
 
-                // Находим расстояние между парой остановок
-                distance += stops_pairs_to_distances.at({ *(sub_it - 1), *sub_it });
+            // Добавляем ребро-расстояние в орграф и информацию о нем в вектор ребер
+            orgraph.AddEdge({ from, to, CountEdgeWeight(edge_info) });
+            edges_.push_back(edge_info);
+        }
+    }
+}
+/**
+ * Добавляет в орграф цепочки вершин поездки: для каждой остановки цепочки - ребро посадки
+ * из выходной вершины остановки, ребро перегона до следующей вершины цепочки
+ * и ребро высадки во входную вершину остановки
+*/
+void TransportRouter::AddRideChainEdges(graph::DirectedWeightedGraph<double>& orgraph) {
+    // Вершины поездки следуют за вершинами остановок
+    graph::VertexId ride_vertex = vertexes_.size() * 2;
 
-                // Добавляем ребра-расстояния в орграф
-                orgraph.AddEdge({
-                    vertexes_.at((*it)->name).out.id, 
-                    vertexes_.at((*sub_it)->name).in.id,
-                    CountTime(distance)
-                });
+    const auto& routes = transport_catalogue_.GetRoutes();
+    for (uint32_t route_id = 0; route_id < routes.size(); ++route_id) {
+        ride_vertex = AddRideChainEdges(orgraph, route_id, ride_vertex);
+    }
+}
+/**
+ * Добавляет в орграф цепочки вершин поездки маршрута route_id, начиная с вершины ride_vertex.
+ * Возвращает первую вершину поездки, следующую за цепочками маршрута
+*/
+graph::VertexId TransportRouter::AddRideChainEdges(graph::DirectedWeightedGraph<double>& orgraph,
+    uint32_t route_id, graph::VertexId ride_vertex) {
+    // Получаем ссылку на словарь с парами остановок и расстояниями между ними
+    const auto& stops_pairs_to_distances = transport_catalogue_.GetStopsToDistances();
 
-                // Вносим информацию в вектор ребер
-                edges_.push_back({
-                    CountTime(distance),
-                    name, 
-                    static_cast<size_t>(std::distance(it, sub_it)),
-                    EdgeType::BUS
-                });
+    const auto& route = transport_catalogue_.GetRoutes()[route_id];
+    for (const auto& [first, last] : GetRideChains(route)) {
+        for (size_t i = first; i <= last; ++i, ++ride_vertex) {
+            const StopVertex& stop_vertex = vertexes_.at(route.stops[i]->name);
 
+            // С последней остановки цепочки дальше не уехать
+            if (i < last) {
+                orgraph.AddEdge({ stop_vertex.out.id, ride_vertex, 0.0 });
+                edges_.emplace_back(route_id, 0, EdgeType::BOARDING);
+            }
+            // На первой остановке цепочки выходить некуда
+            if (i > first) {
+                const double distance = stops_pairs_to_distances.at({ route.stops[i - 1], route.stops[i] });
+                edges_.emplace_back(route_id, 1, EdgeType::RIDE, distance);
+                orgraph.AddEdge({ ride_vertex - 1, ride_vertex, CountEdgeWeight(edges_.back()) });
+
+                orgraph.AddEdge({ ride_vertex, stop_vertex.in.id, 0.0 });
+                edges_.emplace_back(route_id, 0, EdgeType::ALIGHTING);
             }
         }
     }
+    return ride_vertex;
+}
+/**
+ * Возвращает отрезки [first, last] индексов остановок маршрута, по которым можно
+ * проехать без пересадки. Некольцевой маршрут разбивается на прямой и обратный путь
+*/
+std::vector<std::pair<size_t, size_t>> TransportRouter::GetRideChains(const domain::Route& route) const {
+    const size_t stops_count = route.stops.size();
+    if (stops_count < 2) {
+        return {};
+    }
 
-    return orgraph;
+    if (route.is_round) {
+        return { { 0, stops_count - 1 } };
+    }
+    const size_t turnaround = stops_count / 2;
+    return { { 0, turnaround }, { turnaround, stops_count - 1 } };
 }
 /**
- * Заполняет словарь вершин vertexes_, возвращает граф,
- * инициилизированный необходимым количеством вершин
+ * Возвращает число вершин поездки в модели GraphModel::LINEAR
 */
-graph::DirectedWeightedGraph<double> TransportRouter::CreateVertexesAndOrgraph() {
+size_t TransportRouter::CountRideVertexes(size_t first_route_id) const {
+    const auto& routes = transport_catalogue_.GetRoutes();
+    size_t count = 0;
+    for (size_t route_id = first_route_id; route_id < routes.size(); ++route_id) {
+        for (const auto& [first, last] : GetRideChains(routes[route_id])) {
+            count += last - first + 1;
+        }
+    }
+    return count;
+}
+/**
+ * Заполняет словарь вершин vertexes_, возвращает граф, инициилизированный
+ * вершинами остановок и ride_vertex_count вершинами поездки
+*/
+graph::DirectedWeightedGraph<double> TransportRouter::CreateVertexesAndOrgraph(size_t ride_vertex_count) {
     // Итерируемся по остановкам, вносим вершины
     size_t vertex_count = 0;
     for (const auto& stop : transport_catalogue_.GetStops()) {
@@ -172,34 +848,92 @@ graph::DirectedWeightedGraph<double> TransportRouter::CreateVertexesAndOrgraph()
 
         vertexes_[stop.name] = { in, out };
     }
+    vertex_count += ride_vertex_count;
 
     // Создаем орграф с необходимым количеством вершин
     graph::DirectedWeightedGraph<double> orgraph(vertex_count);
     
     // Итерируемся по вершинам, добавляем ребра-ожидания в орграф и вектор ребер
-    for (const auto& [name, data] : vertexes_) {
+    for (const auto& [_, data] : vertexes_) {
         orgraph.AddEdge({
             data.in.id,
             data.out.id,
             static_cast<double>(route_settings_.wait_time)
         });
-        edges_.push_back({
-            static_cast<double>(route_settings_.wait_time),
-            name, 
-            0,
-            EdgeType::STOP
-        });
+        edges_.emplace_back(static_cast<uint32_t>(data.in.id / 2), 0, EdgeType::STOP);
     }
 
     return orgraph;
 }
 
+/**
+ * Инициализирует маршрутизатор при первом обращении. Безопасно для конкурентных вызовов:
+ * инициализацию выполняет один поток, остальные ждут её завершения
+*/
+void TransportRouter::EnsureRouterInitialized() {
+    // После инициализации маршрутизатор только читается, блокировка не нужна
+    if (is_router_initialized_.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    std::lock_guard guard(router_init_mutex_);
+    InitializeGraphRouter();
+    is_router_initialized_.store(IsRouterInitialized(), std::memory_order_release);
+}
+/**
+ * Создает маршрутизатор по расписанию при первом обращении. Рейс маршрута проходит
+ * все его остановки, время в пути между остановками рассчитывается по скорости автобуса.
+ * Безопасно для конкурентных вызовов
+*/
+void TransportRouter::EnsureTimetableInitialized() {
+    if (is_timetable_initialized_.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    std::lock_guard guard(router_init_mutex_);
+    if (timetable_router_) {
+        return;
+    }
+
+    const auto& all_stops = transport_catalogue_.GetStops();
+    for (uint32_t stop_id = 0; stop_id < all_stops.size(); ++stop_id) {
+        timetable_stops_ids_[all_stops[stop_id].name] = stop_id;
+    }
+
+    // Получаем ссылку на словарь с парами остановок и расстояниями между ними
+    const auto& stops_pairs_to_distances = transport_catalogue_.GetStopsToDistances();
+
+    // Линиями становятся маршруты с расписанием
+    std::vector<graph::RaptorRouter<double>::Line> lines;
+    const auto& routes = transport_catalogue_.GetRoutes();
+    for (uint32_t route_id = 0; route_id < routes.size(); ++route_id) {
+        const auto& stops = routes[route_id].stops;
+        if (routes[route_id].departures.empty() || stops.empty()) {
+            continue;
+        }
+
+        graph::RaptorRouter<double>::Line line;
+        line.departures = routes[route_id].departures;
+        for (size_t i = 0; i < stops.size(); ++i) {
+            line.stops.push_back(timetable_stops_ids_.at(stops[i]->name));
+            if (i > 0) {
+                line.segment_times.push_back(CountTime(stops_pairs_to_distances.at({ stops[i - 1], stops[i] })));
+            }
+        }
+
+        lines.push_back(std::move(line));
+        timetable_lines_routes_.push_back(route_id);
+    }
+
+    timetable_router_.emplace(all_stops.size(), std::move(lines));
+    is_timetable_initialized_.store(true, std::memory_order_release);
+}
 /**
  * Инициализирует маршрутизатор
 */
 void TransportRouter::InitializeGraphRouter() {
     // Нельзя инициилизировать router_ повторно
-    if (router_) {
+    if (IsRouterInitialized()) {
         return;
     }
 
@@ -212,16 +946,220 @@ void TransportRouter::InitializeGraphRouter() {
 
     // Создадим орграф на основе данных транспортного справочника
     orgraph_ = GetFilledOrgraph();
+    // Заполненный орграф больше не меняется - переводим его в сжатое представление
+    orgraph_.Freeze();
+    // Компоненты связности зависят только от топологии орграфа
+    connectivity_.emplace(orgraph_);
     // Инициилизируем маршрутизатор орграфа
-    router_.emplace(orgraph_);
+    EmplaceRouter();
 }
 
+/**
+ * Возвращает true, если движок маршрутизации уже создан
+*/
+bool TransportRouter::IsRouterInitialized() const {
+    return !std::holds_alternative<std::monostate>(router_);
+}
+/**
+ * Создает движок маршрутизации над orgraph_ в соответствии с route_settings_
+*/
+void TransportRouter::EmplaceRouter() {
+    // Маршруты, построенные по прежнему орграфу, больше не действительны
+    route_cache_.Clear();
+
+    switch (route_settings_.router_type) {
+    case RouterType::ALL_PAIRS:
+        // Если таблица маршрутов была задана заранее - не пересчитываем её
+        if (routes_table_) {
+            router_.emplace<graph::Router<double>>(orgraph_, std::move(*routes_table_));
+            routes_table_.reset();
+        }
+        else {
+            router_.emplace<graph::Router<double>>(orgraph_, route_settings_.precompute_threads);
+        }
+        break;
+    case RouterType::COMPACT_ALL_PAIRS:
+        // Последнее ребро маршрута задается номером среди входящих ребер вершины
+        orgraph_.BuildReverseIncidence();
+        if (compact_routes_table_) {
+            router_.emplace<graph::CompactRouter<double>>(orgraph_, std::move(*compact_routes_table_));
+            compact_routes_table_.reset();
+        }
+        else {
+            router_.emplace<graph::CompactRouter<double>>(orgraph_, route_settings_.precompute_threads);
+        }
+        break;
+    case RouterType::DIJKSTRA:
+        // Целочисленные веса позволяют вести поиск с поразрядной очередью вместо двоичной кучи
+        if (route_settings_.integer_weights) {
+            integer_orgraph_ = GetIntegerOrgraph();
+            router_.emplace<graph::DijkstraRouter<uint64_t>>(integer_orgraph_);
+        }
+        else {
+            router_.emplace<graph::DijkstraRouter<double>>(orgraph_);
+        }
+        break;
+    case RouterType::A_STAR:
+        PrepareAStarHeuristic();
+        router_.emplace<graph::DijkstraRouter<double>>(orgraph_);
+        break;
+    case RouterType::BIDIRECTIONAL_DIJKSTRA:
+        // Обратному поиску нужны списки входящих ребер
+        orgraph_.BuildReverseIncidence();
+        router_.emplace<graph::BidirectionalDijkstraRouter<double>>(orgraph_);
+        break;
+    case RouterType::CONTRACTION_HIERARCHY:
+        // Если иерархия была задана заранее - не сжимаем граф повторно
+        if (contraction_data_) {
+            router_.emplace<graph::ContractionHierarchyRouter<double>>(orgraph_, std::move(*contraction_data_));
+            contraction_data_.reset();
+        }
+        else {
+            router_.emplace<graph::ContractionHierarchyRouter<double>>(orgraph_);
+        }
+        break;
+    case RouterType::ALT:
+        // Если ориентиры были заданы заранее - не рассчитываем их повторно
+        if (landmark_data_) {
+            router_.emplace<graph::LandmarkRouter<double>>(orgraph_, std::move(*landmark_data_));
+            landmark_data_.reset();
+        }
+        else {
+            // Веса путей до ориентиров рассчитываются поиском по входящим ребрам
+            orgraph_.BuildReverseIncidence();
+            router_.emplace<graph::LandmarkRouter<double>>(orgraph_, route_settings_.landmark_count);
+        }
+        break;
+    case RouterType::MULTILEVEL_DIJKSTRA:
+        // Если разбиение и клики были заданы заранее - не рассчитываем их повторно
+        if (multilevel_data_) {
+            router_.emplace<graph::MultilevelRouter<double>>(orgraph_, std::move(*multilevel_data_));
+            multilevel_data_.reset();
+        }
+        else {
+            router_.emplace<graph::MultilevelRouter<double>>(orgraph_, route_settings_.precompute_threads);
+        }
+        break;
+    }
+
+    // Целочисленная копия орграфа не нужна остальным движкам
+    if (!std::holds_alternative<graph::DijkstraRouter<uint64_t>>(router_)) {
+        integer_orgraph_ = graph::DirectedWeightedGraph<uint64_t>();
+    }
+
+    // Поиск от одной остановки ко многим ведется по орграфу независимо от движка
+    one_to_many_router_.emplace(orgraph_);
+    EmplaceHubLabels();
+}
+/**
+ * Создает индекс хабов над orgraph_, если он включен в route_settings_
+*/
+void TransportRouter::EmplaceHubLabels() {
+    if (!route_settings_.hub_labels) {
+        hub_labels_.reset();
+        hub_labels_data_.reset();
+        return;
+    }
+    // Если метки были заданы заранее - не рассчитываем их повторно
+    if (hub_labels_data_) {
+        hub_labels_.emplace(orgraph_, std::move(*hub_labels_data_));
+        hub_labels_data_.reset();
+    }
+    else {
+        hub_labels_.emplace(orgraph_);
+    }
+}
+
+/**
+ * Готовит оценку A*: координаты каждой вершины орграфа и минимальное время на метр.
+ * Поездка между соседними остановками не быстрее, чем расстояние по прямой, деленное
+ * на скорость velocity, умноженную на наибольшее отношение расстояния по прямой
+ * к расстоянию по дорогам. По неравенству треугольника оценка не превышает время
+ * любого пути до цели, ожидание и посадка её только увеличивают
+*/
+void TransportRouter::PrepareAStarHeuristic() {
+    vertexes_coordinates_.assign(orgraph_.GetVertexCount(), {0.0, 0.0});
+
+    // Вершины остановок идут первыми, в порядке остановок справочника
+    size_t vertex_id = 0;
+    for (const auto& stop : transport_catalogue_.GetStops()) {
+        vertexes_coordinates_[vertex_id++] = { stop.latitude, stop.longitude };
+        vertexes_coordinates_[vertex_id++] = { stop.latitude, stop.longitude };
+    }
+    // Вершина поездки модели LINEAR находится там же, где остановка посадки или высадки
+    for (graph::EdgeId edge_id = 0; edge_id < orgraph_.GetEdgeCount(); ++edge_id) {
+        const auto& edge = orgraph_.GetEdge(edge_id);
+        if (edges_[edge_id].type == EdgeType::BOARDING) {
+            vertexes_coordinates_[edge.to] = vertexes_coordinates_[edge.from];
+        }
+        else if (edges_[edge_id].type == EdgeType::ALIGHTING) {
+            vertexes_coordinates_[edge.from] = vertexes_coordinates_[edge.to];
+        }
+    }
+
+    double max_ratio = 0.0;
+    for (const auto& [stops, distance] : transport_catalogue_.GetStopsToDistances()) {
+        const double geo_distance = geo::ComputeDistance(
+            { stops.first->latitude, stops.first->longitude },
+            { stops.second->latitude, stops.second->longitude });
+        if (std::isnan(geo_distance) || geo_distance == 0.0) {
+            continue;
+        }
+        // Нулевое расстояние по дорогам между разными точками не дает оценить скорость
+        if (distance <= 0.0) {
+            min_minutes_per_meter_ = 0.0;
+            return;
+        }
+        max_ratio = std::max(max_ratio, geo_distance / distance);
+    }
+
+    // Небольшой запас компенсирует погрешность вычисления расстояний
+    min_minutes_per_meter_ = max_ratio == 0.0
+        ? 0.0
+        : CountTime(1.0) / max_ratio * (1.0 - 1e-9);
+}
+
+/**
+ * Возвращает число перегонов поездки в представлении информации о ребре,
+ * выбрасывает std::length_error, если оно не помещается в 16 бит
+*/
+uint16_t TransportRouter::ToSpanCount(size_t span_count) {
+    if (span_count > std::numeric_limits<uint16_t>::max()) {
+        throw std::length_error("Route is too long to store its span count");
+    }
+    return static_cast<uint16_t>(span_count);
+}
 /**
  * Возвращает время в минутах, потраченное на преодоление расстояния distance
  * со скоростью velocity, заданной в route_settings_
 */
-double TransportRouter::CountTime(double distance) {
+double TransportRouter::CountTime(double distance) const {
     return distance / (route_settings_.velocity * 1000.0) * 60.0;
 }
+/**
+ * Возвращает вес ребра по его типу и расстоянию в соответствии с route_settings_.
+ * При integer_weights вес округляется вверх до целых десятых долей секунды: он не становится
+ * меньше времени поездки, и оценка A* остается согласованной. Небольшой запас не дает
+ * погрешности деления округлить вверх и так целое число десятых долей секунды
+*/
+double TransportRouter::CountEdgeWeight(const EdgeInfo& edge) const {
+    double weight = 0.0;
+    switch (edge.type) {
+    case EdgeType::STOP:
+        weight = static_cast<double>(route_settings_.wait_time);
+        break;
+    case EdgeType::BUS:
+    case EdgeType::RIDE:
+        weight = CountTime(edge.distance);
+        break;
+    default:
+        break;
+    }
+    if (!route_settings_.integer_weights) {
+        return weight;
+    }
+    const double deciseconds = std::ceil(weight * DECISECONDS_PER_MINUTE - 1e-6);
+    return deciseconds > 0.0 ? deciseconds / DECISECONDS_PER_MINUTE : 0.0;
+}
 
 } // transport_catalogue
\ No newline at end of file
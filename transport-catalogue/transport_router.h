@@ -1,41 +1,107 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <string_view>
+#include <variant>
 #include <vector>
 #include <unordered_map>
+#include <utility>
 
 #include "transport_catalogue.h"
+#include "geo.h"
+#include "lru_cache.h"
+#include "bidirectional_dijkstra_router.h"
+#include "compact_router.h"
+#include "connectivity_index.h"
+#include "contraction_hierarchy.h"
+#include "dijkstra_router.h"
+#include "hub_labels.h"
+#include "landmark_router.h"
+#include "multilevel_router.h"
+#include "raptor_router.h"
 #include "router.h"
 
 namespace transport_catalogue {
 
+/**
+ * Тип движка маршрутизации:
+ * ALL_PAIRS - предварительный расчет маршрутов между всеми парами вершин,
+ * DIJKSTRA - поиск алгоритмом Дейкстры в момент запроса,
+ * CONTRACTION_HIERARCHY - предварительное сжатие графа и двунаправленный поиск по иерархии,
+ * A_STAR - поиск A* в момент запроса с оценкой по расстоянию между координатами остановок,
+ * BIDIRECTIONAL_DIJKSTRA - двунаправленный поиск Дейкстры в момент запроса,
+ * ALT - поиск A* в момент запроса с оценкой по заранее рассчитанным весам путей до ориентиров,
+ * COMPACT_ALL_PAIRS - предварительный расчет маршрутов между всеми парами вершин в сжатую таблицу
+ * последних ребер маршрутов, веса маршрутов суммируются в момент запроса,
+ * MULTILEVEL_DIJKSTRA - предварительное разбиение графа на вложенные ячейки с кликами путей
+ * через ячейки и многоуровневый поиск Дейкстры, при изменении весов пересчитываются только клики
+*/
+enum class RouterType {
+    ALL_PAIRS, DIJKSTRA, CONTRACTION_HIERARCHY, A_STAR, BIDIRECTIONAL_DIJKSTRA, ALT, COMPACT_ALL_PAIRS,
+    MULTILEVEL_DIJKSTRA
+};
+/**
+ * Модель орграфа маршрутов:
+ * COMPLETE - ребро от каждой остановки маршрута до каждой последующей,
+ * LINEAR - цепочка вершин поездки по каждому маршруту, число ребер линейно по длине маршрутов
+*/
+enum class GraphModel { COMPLETE, LINEAR };
+
 /**
  * Конфигурация автобусов для расчета маршрутов
 */
 struct RouteSettings final {
     int wait_time = 0;
     int velocity = 0;
+    RouterType router_type = RouterType::ALL_PAIRS;
+    GraphModel graph_model = GraphModel::COMPLETE;
+    // Число потоков предварительного расчета маршрутов, в базу не сохраняется
+    size_t precompute_threads = 1;
+    // Число построенных маршрутов, хранимых в кэше. 0 - кэш отключен
+    size_t route_cache_size = 0;
+    // Число ориентиров движка ALT
+    size_t landmark_count = 8;
+    // Строить индекс хабов, отвечающий на запросы времени маршрута без поиска
+    bool hub_labels = false;
+    // Округлять веса ребер до целых десятых долей секунды. Движок DIJKSTRA тогда ведет поиск
+    // по целочисленной копии орграфа
+    bool integer_weights = false;
 };
 
 /**
- * Тип содержания ребра
+ * Тип содержания ребра. BOARDING, RIDE и ALIGHTING - посадка, перегон и высадка
+ * в модели GraphModel::LINEAR, в ответе они сворачиваются в одно ребро BUS
 */
-enum class EdgeType { BUS, STOP };
+enum class EdgeType : uint8_t { BUS, STOP, BOARDING, RIDE, ALIGHTING };
 /**
- * Содержание ребра орграфа
+ * Содержание ребра орграфа. Вес ребра хранится в орграфе, название - в справочнике:
+ * name_id - индекс остановки в GetStops() для ребер STOP, иначе индекс маршрута в GetRoutes()
 */
 struct EdgeInfo final {
-    // EdgeInfo() = default;
-    EdgeInfo(double w, std::string_view n, size_t s, EdgeType t)
-        : weight(w)
-        , name(n)
+    EdgeInfo(uint32_t n, uint16_t s, EdgeType t, double d = 0.0)
+        : distance(d)
+        , name_id(n)
         , span_count(s)
         , type(t) {}
 
-    double weight = 0.0;
-    std::string_view name;
-    size_t span_count = 0;
+    // Расстояние поездки по дорогам, м. Вес ребра определяется им, типом ребра и настройками
+    double distance = 0.0;
+    uint32_t name_id = 0;
+    uint16_t span_count = 0;
+    EdgeType type = EdgeType::BUS;
+};
+/**
+ * Элемент построенного маршрута: ожидание на остановке (STOP) или поездка (BUS)
+ * длительностью time. name_id задается так же, как в EdgeInfo
+*/
+struct RouteItem final {
+    double time = 0.0;
+    uint32_t name_id = 0;
+    uint16_t span_count = 0;
     EdgeType type = EdgeType::BUS;
 };
 
@@ -44,7 +110,28 @@ struct EdgeInfo final {
 */
 struct RouteResult final {
     double time = 0.0;
-    std::vector<EdgeInfo> edges;
+    std::vector<RouteItem> items;
+    // Число вершин, окончательно просмотренных поиском. 0 - движок не ведет поиск в момент запроса
+    size_t settled_vertices = 0;
+};
+
+/**
+ * Результат поиска остановок, достижимых за ограниченное время: названия остановок
+ * с временем маршрута до них в порядке его неубывания
+*/
+struct IsochroneResult final {
+    std::vector<std::pair<std::string_view, double>> stops;
+    size_t settled_vertices = 0;
+};
+
+/**
+ * Результат поиска маршрута по расписанию: время отправления и прибытия (мин от начала суток)
+ * и ребра ожидания и поездок
+*/
+struct JourneyResult final {
+    double departure_time = 0.0;
+    double arrival_time = 0.0;
+    std::vector<RouteItem> items;
 };
 
 /**
@@ -72,34 +159,163 @@ struct StopVertex {
 */
 class TransportRouter final {
 public:
+    // Таблица рассчитанных маршрутов между всеми парами вершин
+    using RoutesTable = graph::Router<double>::RoutesInternalData;
+    // Сжатая таблица последних ребер маршрутов между всеми парами вершин
+    using CompactRoutesTable = graph::CompactRouter<double>::CompactRoutesData;
+    // Ребра-сокращения и ранги вершин иерархии сжатий
+    using ContractionData = graph::ContractionHierarchyRouter<double>::ContractionData;
+    // Ориентиры ALT и веса путей до них
+    using LandmarkData = graph::LandmarkRouter<double>::LandmarkData;
+    // Разбиение орграфа на ячейки и клики ячеек многоуровневого поиска
+    using MultilevelData = graph::MultilevelRouter<double>::MultilevelData;
+    // Номера компонент связности вершин орграфа
+    using ComponentsData = graph::ConnectivityIndex::ComponentsData;
+    // Порядок вершин и метки индекса хабов
+    using HubLabelsData = graph::HubLabels<double>::LabelsData;
+
     explicit TransportRouter(TransportCatalogue& transport_catalogue);
 
     void InitializeGraphRouter();
 
     void SetRouteSettings(RouteSettings route_settings);
+    void Customize(RouteSettings route_settings);
     void SetEdges(const std::vector<EdgeInfo>& edges);
-    void SetGraphAndRouter(const graph::DirectedWeightedGraph<double>& orgraph);
+    void SetRoutesTable(RoutesTable routes_table);
+    void SetCompactRoutesTable(CompactRoutesTable compact_routes_table);
+    void SetContractionData(ContractionData contraction_data);
+    void SetLandmarkData(LandmarkData landmark_data);
+    void SetMultilevelData(MultilevelData multilevel_data);
+    void SetComponentsData(ComponentsData components_data);
+    void SetHubLabelsData(HubLabelsData hub_labels_data);
+    void SetGraphAndRouter(graph::DirectedWeightedGraph<double> orgraph);
+    void AddNewRoutes();
 
     const RouteSettings& GetRouteSettings() const;
+    std::string_view GetStopName(uint32_t stop_id) const;
+    std::string_view GetRouteName(uint32_t route_id) const;
     const std::vector<EdgeInfo>& GetEdges() const;
     const graph::DirectedWeightedGraph<double>& GetGraph() const;
+    const RoutesTable* GetRoutesTable() const;
+    const CompactRoutesTable* GetCompactRoutesTable() const;
+    const ContractionData* GetContractionData() const;
+    const LandmarkData* GetLandmarkData() const;
+    const MultilevelData* GetMultilevelData() const;
+    const ComponentsData* GetComponentsData() const;
+    const HubLabelsData* GetHubLabelsData() const;
+
+    std::shared_ptr<const RouteResult> BuildRoute(std::string_view from, std::string_view to);
+    std::vector<std::shared_ptr<const RouteResult>> BuildRoutes(std::string_view from,
+        const std::vector<std::string_view>& to);
+    std::optional<double> ComputeRouteTime(std::string_view from, std::string_view to);
+    std::vector<std::optional<double>> ComputeRouteTimes(std::string_view from,
+        const std::vector<std::string_view>& to);
+
+    std::optional<IsochroneResult> BuildIsochrone(std::string_view from, double max_time);
+    std::optional<JourneyResult> BuildJourney(std::string_view from, std::string_view to,
+        double departure_time, size_t max_transfers);
 
-    std::optional<RouteResult> BuildRoute(std::string_view from, std::string_view to);
+    size_t GetRouteCacheHits() const;
+    size_t GetRouteCacheMisses() const;
 
 private:
     RouteSettings route_settings_; // Конфигурация автобусов
     const TransportCatalogue& transport_catalogue_; // Ссылка на транспортный справочник
 
+    // Движок маршрутизации, std::monostate - маршрутизатор не инициилизирован
+    using RouterEngine = std::variant<std::monostate,
+        graph::Router<double>, graph::DijkstraRouter<double>,
+        graph::ContractionHierarchyRouter<double>, graph::BidirectionalDijkstraRouter<double>,
+        graph::LandmarkRouter<double>, graph::CompactRouter<double>, graph::MultilevelRouter<double>,
+        graph::DijkstraRouter<uint64_t>>;
+
+    // Число десятых долей секунды в минуте - единиц целочисленных весов
+    static constexpr double DECISECONDS_PER_MINUTE = 600.0;
+
     graph::DirectedWeightedGraph<double> orgraph_; // Орграф, содержащий все маршруты
-    mutable std::optional<graph::Router<double>> router_ = std::nullopt; // Маршрутизатор орграфа
+    // Орграф orgraph_ с весами в десятых долях секунды для движка DIJKSTRA с integer_weights
+    graph::DirectedWeightedGraph<uint64_t> integer_orgraph_;
+    RouterEngine router_; // Маршрутизатор орграфа
+    // Маршрутизатор запросов от одной остановки ко многим
+    std::optional<graph::DijkstraRouter<double>> one_to_many_router_ = std::nullopt;
+    // Защищает ленивую инициализацию router_ при конкурентных запросах
+    std::mutex router_init_mutex_;
+    std::atomic<bool> is_router_initialized_{ false };
+
+    // Маршрутизатор по расписанию, создается при первом запросе
+    std::optional<graph::RaptorRouter<double>> timetable_router_ = std::nullopt;
+    // Id остановок в timetable_router_ - их индексы в справочнике
+    std::unordered_map<std::string_view, uint32_t> timetable_stops_ids_;
+    std::vector<uint32_t> timetable_lines_routes_; // Индексы маршрутов линий timetable_router_
+    std::atomic<bool> is_timetable_initialized_{ false };
+    // Десериализованная таблица маршрутов, ожидающая создания маршрутизатора
+    std::optional<RoutesTable> routes_table_ = std::nullopt;
+    // Десериализованная сжатая таблица маршрутов, ожидающая создания маршрутизатора
+    std::optional<CompactRoutesTable> compact_routes_table_ = std::nullopt;
+    // Десериализованная иерархия сжатий, ожидающая создания маршрутизатора
+    std::optional<ContractionData> contraction_data_ = std::nullopt;
+    // Десериализованные ориентиры ALT, ожидающие создания маршрутизатора
+    std::optional<LandmarkData> landmark_data_ = std::nullopt;
+    // Десериализованные разбиение и клики, ожидающие создания маршрутизатора
+    std::optional<MultilevelData> multilevel_data_ = std::nullopt;
+    // Индекс связности орграфа, отбрасывающий пары остановок без пути между ними
+    std::optional<graph::ConnectivityIndex> connectivity_ = std::nullopt;
+    // Десериализованные компоненты связности, ожидающие создания индекса
+    std::optional<ComponentsData> components_data_ = std::nullopt;
+    // Индекс хабов для запросов времени маршрута, создается при route_settings_.hub_labels
+    std::optional<graph::HubLabels<double>> hub_labels_ = std::nullopt;
+    // Десериализованные метки индекса хабов, ожидающие его создания
+    std::optional<HubLabelsData> hub_labels_data_ = std::nullopt;
 
     std::vector<EdgeInfo> edges_; // Вектор основной информации о ребрах
+    size_t graph_routes_count_ = 0; // Число маршрутов справочника, ребра которых есть в орграфе
     std::unordered_map<std::string_view, StopVertex> vertexes_; // Словарь вершин остановок
 
+    // Координаты вершин орграфа и минимальное время на метр расстояния между координатами
+    // для оценки A*
+    std::vector<geo::Coordinates> vertexes_coordinates_;
+    double min_minutes_per_meter_ = 0.0;
+
+    // Хэшер пары вершин начала и конца маршрута
+    struct VertexesPairHasher {
+        size_t operator()(const std::pair<graph::VertexId, graph::VertexId>& vertexes) const {
+            return std::hash<graph::VertexId>{}(vertexes.first) * 37
+                + std::hash<graph::VertexId>{}(vertexes.second);
+        }
+    };
+    // Id ребра маршрута между парой вершин
+    using PairsToEdges = std::unordered_map<std::pair<graph::VertexId, graph::VertexId>, graph::EdgeId,
+        VertexesPairHasher>;
+    // Кэш построенных маршрутов по паре вершин, nullptr - маршрут не найден
+    LruCache<std::pair<graph::VertexId, graph::VertexId>, std::shared_ptr<const RouteResult>,
+        VertexesPairHasher> route_cache_;
+
     graph::DirectedWeightedGraph<double> GetFilledOrgraph();
-    graph::DirectedWeightedGraph<double> CreateVertexesAndOrgraph();
+    graph::DirectedWeightedGraph<uint64_t> GetIntegerOrgraph() const;
+    graph::DirectedWeightedGraph<double> CreateVertexesAndOrgraph(size_t ride_vertex_count);
+    void AddRouteSpanEdges(graph::DirectedWeightedGraph<double>& orgraph);
+    void AddRouteSpanEdges(graph::DirectedWeightedGraph<double>& orgraph, uint32_t route_id,
+        PairsToEdges& pairs_to_edges);
+    void AddRideChainEdges(graph::DirectedWeightedGraph<double>& orgraph);
+    graph::VertexId AddRideChainEdges(graph::DirectedWeightedGraph<double>& orgraph, uint32_t route_id,
+        graph::VertexId ride_vertex);
+    std::vector<std::pair<size_t, size_t>> GetRideChains(const domain::Route& route) const;
+    size_t CountRideVertexes(size_t first_route_id = 0) const;
+
+    std::optional<graph::VertexId> FindStopVertex(std::string_view stop) const;
+    std::shared_ptr<const RouteResult> MakeRouteResult(const graph::Router<double>::RouteInfo& route,
+        size_t settled_vertices) const;
+
+    void EnsureRouterInitialized();
+    void EnsureTimetableInitialized();
+    bool IsRouterInitialized() const;
+    void EmplaceRouter();
+    void EmplaceHubLabels();
+    void PrepareAStarHeuristic();
 
-    double CountTime(double distance);
+    static uint16_t ToSpanCount(size_t span_count);
+    double CountTime(double distance) const;
+    double CountEdgeWeight(const EdgeInfo& edge) const;
 };
 
 } // transport_catalogue
\ No newline at end of file